@@ -16,6 +16,7 @@
 // ================================================================================
 
 #if !_HAS_CXX17
-	// Global tracker to handle memory allocations
-	MemTrackifyPlus GlobalMemTracker::globalTracker_;
+	// Global tracker to handle memory allocations (constructed on first use)
+	alignas(MemTrackifyPlus) unsigned char GlobalMemTracker::trackerStorage_[sizeof(MemTrackifyPlus)];
+	std::atomic<int> GlobalMemTracker::trackerState_(GlobalMemTracker::TRACKER_UNINITIALIZED);
 #endif
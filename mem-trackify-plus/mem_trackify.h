@@ -25,6 +25,40 @@
  *		- Ensure thread-safety when tracking memory allocations/deallocations.
  *		- If your program has no multi-threads, you can skip this macro.
  *
+ *   _MTP_FLIGHT_RECORDER
+ *		- Keep the last allocation/deallocation events of each thread in a ring buffer (lock-free).
+ *		- Use MemTrackifyPlus::printFlightRecord() to dump them in time order, e.g. to investigate a double free.
+ *		- The ring size (events per thread) can be set with _MTP_FLIGHT_RECORDER_SIZE (default: 4096).
+ *
+ *   _MTP_GROWTH_TRACKING
+ *		- Follow the buffers grown by alloc-copy-free cycles in chains, per callsite or allocator tag.
+ *		- Use MemTrackifyPlus::printGrowthReport() to list them with a suggested initial capacity.
+ *		- Costs a lookup per tracked allocation/deallocation, callsites and tags need _MTP_DEBUG.
+ *		- The blocks of the plain operator new (STL containers, libraries) are keyed by their caller's return address.
+ *
+ *   _MTP_ALLOCATOR_BACKEND
+ *		- Backing allocator of the tracked blocks (default: MemTrackifyPlus::LibcBackend, the C runtime heap).
+ *		- Use MemTrackifyPlus::SymbolBackend<...> for any allocator exposing malloc-like symbols (jemalloc, mimalloc...),
+ *		  or MemTrackifyPlus::DynamicBackend to select it at startup with MemTrackifyPlus::setAllocatorBackend().
+ *
+ *   _MTP_SMALL_OBJECT_ALLOCATOR
+ *		- Serve the tracked blocks of up to 256 bytes from a built-in thread-caching slab allocator.
+ *		- Their live slots are tracked by one bit each in their slab, instead of a tracking table entry
+ *		  (no callsite, no allocation hooks), see MemTrackifyPlus::getSmallObjectStats().
+ *
+ *   MTP_TRACKING (environment variable)
+ *		- Set to 0/off/false to start the program with tracking disabled, or 1/on/true to force it on.
+ *		- Tracking can also be switched at runtime with MemTrackifyPlus::setTrackingEnabled().
+ *		- While disabled, allocations go straight to malloc/free, blocks tracked earlier are still freed correctly.
+ *
+ *   MTP_OPTIONS (environment variable)
+ *		- Runtime configuration parsed once at startup, as comma-separated key=value pairs:
+ *			tracking=0|1, flight=0|1, signals=0|1, report=text|json|csv|binary[:path],
+ *			persist=path, persist_callsites=N, persist_events=N, small=N, limit=N,
+ *			profile=path (counts accept k/m/g suffixes)
+ *		- Example: MTP_OPTIONS=report=json:/tmp/leaks.jsonl,signals=1
+ *		- Unknown options are ignored (see MemTrackifyPlus::getRuntimeOptions()).
+ *
  *   _MTP_CONSOLE_REPORT_ON_TERMINATION
  *		- Display memory leak report and garbage collecting progress on program termination.
  *		- Only enable this macro if you're using a Console Application.
@@ -86,10 +120,23 @@
 
 #ifdef _MTP_THREADSAFETY
 	#include <mutex>
+	#include <thread>
+	#include <future>
+	#include <condition_variable>
+	#include <deque>
 #endif // _MTP_THREADSAFETY
 
+#ifdef _MTP_FLIGHT_RECORDER
+	#ifndef _MTP_FLIGHT_RECORDER_SIZE
+		#define _MTP_FLIGHT_RECORDER_SIZE	4096
+	#endif // !_MTP_FLIGHT_RECORDER_SIZE
+#endif // _MTP_FLIGHT_RECORDER
+
 #include <atomic>
+#include <chrono>
 #include <vector>
+#include <iterator>
+#include <algorithm>
 #include <unordered_map>
 
 
@@ -153,6 +200,74 @@
 	#error _HAS_CXX26 must imply _HAS_CXX23.
 #endif
 
+#ifndef _MTP_PREFETCH
+	#if defined(__GNUC__) || defined(__clang__)
+		#define _MTP_PREFETCH(addr)		__builtin_prefetch(addr)
+	#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		#include <intrin.h>
+		#define _MTP_PREFETCH(addr)		_mm_prefetch(reinterpret_cast<const char*>(addr), _MM_HINT_T0)
+	#else
+		#define _MTP_PREFETCH(addr)		((void)(addr))
+	#endif
+#endif // _MTP_PREFETCH
+
+#ifndef _MTP_RETURN_ADDRESS
+	#if defined(__GNUC__) || defined(__clang__)
+		#define _MTP_RETURN_ADDRESS()	__builtin_return_address(0)
+	#elif defined(_MSC_VER)
+		#include <intrin.h>
+		#pragma intrinsic(_ReturnAddress)
+		#define _MTP_RETURN_ADDRESS()	_ReturnAddress()
+	#else
+		#define _MTP_RETURN_ADDRESS()	nullptr
+	#endif
+#endif // _MTP_RETURN_ADDRESS
+
+// Backing allocator of the tracked blocks (a MemTrackifyPlus backend type, see MemTrackifyPlus::LibcBackend)
+#ifndef _MTP_ALLOCATOR_BACKEND
+	#define _MTP_ALLOCATOR_BACKEND MemTrackifyPlus::LibcBackend
+#endif // _MTP_ALLOCATOR_BACKEND
+
+#ifndef _MTP_CONSTINIT
+	#ifdef __cpp_constinit
+		#define _MTP_CONSTINIT constinit
+	#else
+		#define _MTP_CONSTINIT
+	#endif
+#endif // _MTP_CONSTINIT
+
+// Report output dependencies (fast number formatting, raw file I/O, signal dumps)
+#include <cstddef>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+
+#if _HAS_CXX17
+	#include <charconv>
+	#if __has_include(<memory_resource>)
+		#include <memory_resource>
+	#endif
+#endif // _HAS_CXX17
+
+#ifdef _WIN32
+	#include <io.h>
+	#include <fcntl.h>
+	#include <sys/stat.h>
+#else
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/uio.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif // _WIN32
+
+// Usable size of the libc blocks
+#if defined(_WIN32) || defined(__GLIBC__) || defined(__ANDROID__)
+	#include <malloc.h>
+#elif defined(__APPLE__)
+	#include <malloc/malloc.h>
+#endif
+
 // [[nodiscard]] attributes on STL functions
 #ifndef _NODISCARD
 	#ifndef _HAS_NODISCARD
@@ -201,6 +316,306 @@ public:
 		const char* file = nullptr;
 		int32_t		line = -1;
 	};
+	struct AllocRecord {				// Struct to describe a live allocation (owns no storage)
+		void*		address = nullptr;
+		size_t		size = 0;
+		bool		isArray = false;
+		DebugInfo	callsite;
+	};
+
+	enum class LeakGroupBy {			// Grouping key of the top leaks report
+		Callsite,						// Same file and line
+		File,							// Same file
+		Size,							// Same block size
+	};
+	enum class LeakRankBy {				// Ranking order of the top leaks report
+		Bytes,							// Largest total size first
+		Count,							// Most blocks first
+	};
+	struct LeakGroup {					// Struct to hold the aggregate of a group of live allocations
+		DebugInfo	callsite;			// Group callsite (the line is -1 when grouped by file)
+		size_t		blockSize = 0;		// Group block size (only when grouped by size)
+		size_t		count = 0;			// Number of live blocks in the group
+		size_t		bytes = 0;			// Total size of the live blocks in the group
+	};
+
+	struct GrowthSite {					// Struct to hold the reallocation chains of a callsite (buffers grown by alloc-copy-free cycles)
+		DebugInfo	callsite;
+		size_t		chainCount = 0;			// Number of chains (finished or still live)
+		size_t		reallocations = 0;		// Number of growth steps of all the chains
+		size_t		bytesCopied = 0;		// Bytes copied out of the outgrown buffers (their sizes)
+		size_t		longestChain = 0;		// Most growth steps of a single chain
+		size_t		largestFinalBytes = 0;	// Largest final buffer of a chain
+		size_t		suggestedCapacity = 0;	// Final buffer size covering 90% of the chains (initial capacity to reserve)
+	};
+
+	// Components of the tracker's own memory
+	enum class OverheadCategory {
+		Table,								// Tracking table (and the changes deferred by a pinned epoch)
+		DebugInfo,							// Debug tracking info (with _MTP_DEBUG)
+		Callsites,							// Callsite tables: small block headers and groups, slab headers, persistent state mapping
+		Buffers,							// Report buffers and temporaries, flight recorder rings, hook lists, pool slabs
+	};
+	static constexpr size_t OVERHEAD_CATEGORY_COUNT = 4;
+
+	struct TrackerOverhead {			// Struct to hold the breakdown of the tracker's own memory and CPU overhead
+		size_t		tableBytes = 0;
+		size_t		debugInfoBytes = 0;
+		size_t		callsiteBytes = 0;
+		size_t		bufferBytes = 0;
+		size_t		fixedBytes = 0;				// The tracker object itself
+		size_t		totalBytes = 0;
+		uint64_t	sampledOperations = 0;		// Number of timed tracking operations (one out of OVERHEAD_SAMPLE_RATE per thread)
+		uint64_t	averageNanoseconds = 0;		// Average time spent tracking one allocation/deallocation
+		uint64_t	cpuNanoseconds = 0;			// Estimated total time spent tracking (sampled time x sample rate)
+	};
+
+#ifdef _MTP_SMALL_OBJECT_ALLOCATOR
+	struct SmallObjectStats {			// Struct to hold the state of the small object allocator (see _MTP_SMALL_OBJECT_ALLOCATOR)
+		size_t		slabCount = 0;
+		size_t		slabBytes = 0;
+		size_t		liveCount = 0;		// Number of live small objects (set bits of the slab bitmaps)
+		size_t		liveBytes = 0;		// Total size of the slots of the live small objects
+	};
+#endif // _MTP_SMALL_OBJECT_ALLOCATOR
+
+	struct PoolRegistration {			// Struct to describe a typed object pool to the leak reports (see smartPool)
+		using LiveVisitor = void (*)(const void* object, size_t size, void* context);
+		const char*			name = nullptr;
+		size_t				objectSize = 0;
+		void				(*forEachLive)(LiveVisitor visitor, void* context) = nullptr;
+		PoolRegistration*	next = nullptr;
+	};
+	struct PoolObject {					// Struct to describe a live object of a registered pool (owns no storage)
+		const void*			address = nullptr;
+		size_t				size = 0;
+		const char*			pool = nullptr;		// Pool name
+	};
+
+	// Allocator for the tracker's own storage, bypasses the tracked operator new/delete
+	// and accounts its heap blocks in an overhead category
+	// Note: The blocks are accounted in the counters of the owning tracker, or in the counters shared by all
+	//		 trackers when default-constructed (temporaries, report buffers, ...)
+	template<typename _Ty, OverheadCategory _Category = OverheadCategory::Buffers>
+	class InternalAllocator {
+	public:
+		using value_type = _Ty;
+		template<typename _Other>
+		struct rebind { using other = InternalAllocator<_Other, _Category>; };
+		template<typename, OverheadCategory>
+		friend class InternalAllocator;
+
+		// Construction
+		InternalAllocator() noexcept : counters_(overheadCounters()) {};
+		explicit InternalAllocator(std::atomic<size_t>* counters) noexcept : counters_(counters) {};
+		template<typename _Other>
+		InternalAllocator(const InternalAllocator<_Other, _Category>& other) noexcept : counters_(other.counters_) {};
+
+		// Operations
+		_NODISCARD _Ty* allocate(size_t count) {
+			void* ptr = std::malloc(count * sizeof(_Ty));
+			if (!ptr) throw std::bad_alloc();
+			counters_[static_cast<size_t>(_Category)].fetch_add(getHeapBlockCost(count * sizeof(_Ty)), std::memory_order_relaxed);
+			return static_cast<_Ty*>(ptr);
+		};
+		void deallocate(_Ty* ptr, size_t count) noexcept {
+			std::free(ptr);
+			counters_[static_cast<size_t>(_Category)].fetch_sub(getHeapBlockCost(count * sizeof(_Ty)), std::memory_order_relaxed);
+		};
+
+		template<typename _Other>
+		_NODISCARD bool operator==(const InternalAllocator<_Other, _Category>& other) const noexcept { return counters_ == other.counters_; };
+		template<typename _Other>
+		_NODISCARD bool operator!=(const InternalAllocator<_Other, _Category>& other) const noexcept { return counters_ != other.counters_; };
+
+	private:
+		std::atomic<size_t>*	counters_;			// Overhead counters, one per category
+	};
+
+	// Holds an instance constructed on first use and never destroyed (for the state shared by the allocators,
+	// their blocks and objects may still be freed during the static destruction)
+	// Note: There is one instance per type and key, always get it with the same constructor arguments
+	template<typename _Ty, typename _Key = _Ty>
+	class NeverDestroyed {
+	public:
+		template<typename... _Args>
+		_NODISCARD static _Ty& get(_Args&&... args) {
+			alignas(_Ty) static unsigned char storage[sizeof(_Ty)];
+			static _Ty* instance = ::new(static_cast<void*>(storage)) _Ty(std::forward<_Args>(args)...);
+			return *instance;
+		};
+	};
+
+#ifdef _MTP_THREADSAFETY
+	// Locks of the tracker, also used by the pools
+	using MutexObj			= typename std::recursive_mutex;
+	using MutexLockGuard	= typename std::lock_guard<MutexObj>;
+	using MutexUniqueLock	= typename std::unique_lock<MutexObj>;
+#endif // _MTP_THREADSAFETY
+
+	// Backing allocators of the tracked blocks, selected at compile time with _MTP_ALLOCATOR_BACKEND
+	// Note: A backend is a type with the static functions below, called directly by the tracker (no indirection).
+	//		 allocate() and alignedAllocate() return nullptr on failure, aligned blocks are released by alignedDeallocate().
+	struct LibcBackend {				// Default backend (C runtime heap)
+		_NODISCARD static void* allocate(size_t size) noexcept { return std::malloc(size); };
+		static void deallocate(void* ptr) noexcept { std::free(ptr); };
+		_NODISCARD static size_t usableSize(void* ptr) noexcept {
+#if defined(_WIN32)
+			return ptr ? _msize(ptr) : 0;
+#elif defined(__GLIBC__) || defined(__ANDROID__)
+			return malloc_usable_size(ptr);
+#elif defined(__APPLE__)
+			return ptr ? malloc_size(ptr) : 0;
+#else
+			(void)ptr;
+			return 0;					// Unknown on this platform
+#endif
+		};
+		_NODISCARD static void* alignedAllocate(size_t size, size_t alignment) noexcept {
+#ifdef _WIN32
+			return _aligned_malloc(size, alignment);
+#else
+			void* ptr = nullptr;
+			if (alignment < sizeof(void*)) alignment = sizeof(void*);
+			return (posix_memalign(&ptr, alignment, size) == 0) ? ptr : nullptr;
+#endif // _WIN32
+		};
+		static void alignedDeallocate(void* ptr) noexcept {
+#ifdef _WIN32
+			_aligned_free(ptr);
+#else
+			std::free(ptr);
+#endif // _WIN32
+		};
+	};
+
+#if _HAS_CXX17
+	// Adapter for any allocator exposing malloc-like symbols, e.g.
+	//   SymbolBackend<&je_malloc, &je_free, &je_malloc_usable_size, &je_aligned_alloc>
+	//   SymbolBackend<&mi_malloc, &mi_free, &mi_usable_size, &mi_aligned_alloc>
+	// The aligned allocation function takes (alignment, size) like aligned_alloc(),
+	// its blocks are released by the deallocation function unless another one is given
+	template<auto _Allocate, auto _Deallocate, auto _UsableSize, auto _AlignedAllocate, auto _AlignedDeallocate = _Deallocate>
+	struct SymbolBackend {
+		_NODISCARD static void* allocate(size_t size) noexcept { return _Allocate(size); };
+		static void deallocate(void* ptr) noexcept { _Deallocate(ptr); };
+		_NODISCARD static size_t usableSize(void* ptr) noexcept { return ptr ? static_cast<size_t>(_UsableSize(ptr)) : 0; };
+		_NODISCARD static void* alignedAllocate(size_t size, size_t alignment) noexcept {
+			if (alignment < sizeof(void*)) alignment = sizeof(void*);
+			return _AlignedAllocate(alignment, (size + alignment - 1) & ~(alignment - 1));
+		};
+		static void alignedDeallocate(void* ptr) noexcept { _AlignedDeallocate(ptr); };
+	};
+#endif // _HAS_CXX17
+
+	struct AllocatorFunctions {			// Struct to hold the functions of a backend selected at startup
+		void*	(*allocate)(size_t size) = nullptr;
+		void	(*deallocate)(void* ptr) = nullptr;
+		size_t	(*usableSize)(void* ptr) = nullptr;
+		void*	(*alignedAllocate)(size_t size, size_t alignment) = nullptr;
+		void	(*alignedDeallocate)(void* ptr) = nullptr;
+	};
+
+	// Backend forwarding to the functions given to setAllocatorBackend() (the C runtime heap until then)
+	struct DynamicBackend {
+		_NODISCARD static void* allocate(size_t size) noexcept { return getFunctions(true).allocate(size); };
+		static void deallocate(void* ptr) noexcept { getFunctions(false).deallocate(ptr); };
+		_NODISCARD static size_t usableSize(void* ptr) noexcept { return getFunctions(false).usableSize(ptr); };
+		_NODISCARD static void* alignedAllocate(size_t size, size_t alignment) noexcept { return getFunctions(true).alignedAllocate(size, alignment); };
+		static void alignedDeallocate(void* ptr) noexcept { getFunctions(false).alignedDeallocate(ptr); };
+
+		// Select the functions, only before the first allocation (return false once a block was allocated)
+		static bool select(const AllocatorFunctions& functions) noexcept {
+			if (!functions.allocate || !functions.deallocate || !functions.usableSize
+				|| !functions.alignedAllocate || !functions.alignedDeallocate) return false;
+			if (getState().isUsed.load(std::memory_order_acquire)) return false;
+			getState().functions = functions;
+			return true;
+		};
+
+	private:
+		struct State {
+			AllocatorFunctions	functions{ &LibcBackend::allocate, &LibcBackend::deallocate, &LibcBackend::usableSize,
+										   &LibcBackend::alignedAllocate, &LibcBackend::alignedDeallocate };
+			std::atomic<bool>	isUsed{ false };
+		};
+		_NODISCARD static State& getState(void) noexcept {
+			static State state;
+			return state;
+		};
+		_NODISCARD static const AllocatorFunctions& getFunctions(bool isAllocating) noexcept {
+			State& state = getState();
+			if (isAllocating && !state.isUsed.load(std::memory_order_relaxed)) state.isUsed.store(true, std::memory_order_release);
+			return state.functions;
+		};
+	};
+
+	// Backend of the tracked blocks
+	using AllocatorBackend	= _MTP_ALLOCATOR_BACKEND;
+
+	// Consistent copy of all live allocation records, stored outside of the tracked heap
+	using AllocSnapshot		= typename std::vector<AllocRecord, InternalAllocator<AllocRecord>>;
+	// Largest leak groups, ordered from the largest
+	using TopLeaks			= typename std::vector<LeakGroup, InternalAllocator<LeakGroup>>;
+	// Live objects of the registered pools
+	using PoolObjects		= typename std::vector<PoolObject, InternalAllocator<PoolObject>>;
+	// Callsites with reallocation chains, ordered from the most bytes copied
+	using GrowthSites		= typename std::vector<GrowthSite, InternalAllocator<GrowthSite>>;
+
+	// Allocation event subscriber: (block address, block size, array flag, callsite, thread index, user context)
+	// Note: Hooks run outside of the tracker lock and may allocate (nested events are not reported to the hooks).
+	//		 Hooks must not throw, free hooks run right before the block is released.
+	using AllocHook			= void (*)(void* ptr, size_t size, bool isArray, const DebugInfo& callsite, uint32_t threadIndex, void* context);
+	using FreeHook			= AllocHook;
+	using HookId			= uint32_t;
+
+	struct OverflowSummary {			// Struct to hold the blocks summarized once the tracker memory limit is reached
+		size_t		liveCount = 0;		// Number of live summarized blocks
+		size_t		liveBytes = 0;		// Total size of the live summarized blocks
+		size_t		totalCount = 0;		// Number of blocks summarized since the limit was first reached
+		size_t		totalBytes = 0;		// Total size of the blocks summarized since the limit was first reached
+	};
+
+	struct ReportExtras {				// Struct to hold the live blocks reported beside the tracking table records
+		TopLeaks		smallBlocks;		// Small block groups per callsite (blockSize is the size class)
+		TopLeaks		smallObjects;		// Small objects per slot size (blockSize is the slot size, no callsite)
+		PoolObjects		poolObjects;		// Live objects of the registered pools
+		OverflowSummary	overflow;			// Blocks summarized once the tracker memory limit was reached
+	};
+
+	struct StartupProfile {				// Struct to hold the allocation profile of a previous run (see MTP_OPTIONS profile=path)
+		static constexpr uint32_t VERSION = 1;
+		static constexpr uint32_t MAX_SIZE_CLASSES = 8;
+		struct SizeClass {
+			uint64_t	maxSize;				// Upper bound of the size class (power of two)
+			uint64_t	count;					// Number of blocks allocated in the size class
+		};
+		char		magic[8] = {};				// "MTPPROF\0"
+		uint32_t	version = 0;
+		uint32_t	sizeClassCount = 0;
+		uint64_t	peakLiveCount = 0;			// Peak number of blocks in the tracking table
+		uint64_t	peakSmallCount = 0;			// Peak number of blocks counted per callsite
+		uint64_t	totalAllocs = 0;			// Number of tracked allocations
+		SizeClass	sizeClasses[MAX_SIZE_CLASSES] = {};	// Most frequent size classes, from the most frequent
+	};
+
+	// Runtime configuration, parsed once from the MTP_OPTIONS environment variable
+	// (comma-separated key=value pairs, e.g. "report=json:/tmp/leaks.jsonl,signals=1,persist=/var/tmp/app.mtp")
+	struct RuntimeOptions {
+		static constexpr size_t MAX_PATH_LENGTH = 256;
+		bool		isTrackingEnabled = true;			// tracking=0|1
+		bool		isFlightRecorderEnabled = true;		// flight=0|1 (with _MTP_FLIGHT_RECORDER)
+		bool		isSignalDump = false;				// signals=0|1 (dump on SIGUSR1 and on crashes, to stderr)
+		uint8_t		reportFormat = 0;					// report=text|json|csv|binary[:path] on termination (0: none)
+		char		reportPath[MAX_PATH_LENGTH] = {};	// Termination report file (empty: console)
+		char		persistPath[MAX_PATH_LENGTH] = {};	// persist=path (crash-persistent state file)
+		uint32_t	persistCallsites = 4096;			// persist_callsites=N
+		uint32_t	persistEvents = 0;					// persist_events=N
+		uint32_t	smallBlockThreshold = 0;			// small=N (blocks under N bytes are only counted per callsite)
+		uint64_t	trackerMemoryLimit = 0;				// limit=N (per-address tracker memory cap in bytes, 0: unlimited)
+		char		profilePath[MAX_PATH_LENGTH] = {};	// profile=path (presize from the profile of the previous run, write it on exit)
+		uint32_t	unknownCount = 0;					// Number of unknown or invalid options (ignored)
+	};
 
 private:
 	using Address			= typename void*;
@@ -208,45 +623,134 @@ private:
 	using StringStreamData	= typename std::ostringstream;
 	using AtomicFlag		= typename std::atomic<bool>;
 	using AllocTrackObj		= typename std::pair<Address, AllocInfo>;
-	using AllocTrackData	= typename std::unordered_map<Address, AllocInfo>;
+	using AllocTrackData	= typename std::unordered_map<Address, AllocInfo, std::hash<Address>, std::equal_to<Address>,
+														 InternalAllocator<std::pair<const Address, AllocInfo>, OverheadCategory::Table>>;
 	using DebugTrackObj		= typename std::pair<Address, DebugInfo>;
-	using DebugTrackData	= typename std::unordered_map<Address, DebugInfo>;
+	using DebugTrackData	= typename std::unordered_map<Address, DebugInfo, std::hash<Address>, std::equal_to<Address>,
+														 InternalAllocator<std::pair<const Address, DebugInfo>, OverheadCategory::DebugInfo>>;
+	struct EpochDeltaInfo {				// Struct to hold a tracking change deferred while an epoch is pinned
+		AllocInfo	allocInfo;
+		DebugInfo	debugInfo;
+		bool		isLive;
+	};
+	using EpochDeltaData	= typename std::unordered_map<Address, EpochDeltaInfo, std::hash<Address>, std::equal_to<Address>,
+														 InternalAllocator<std::pair<const Address, EpochDeltaInfo>, OverheadCategory::Table>>;
+	struct LeakGroupKey {				// Struct to identify a group of the top leaks report
+		const char*	file = nullptr;
+		int32_t		line = -1;
+		size_t		blockSize = 0;
+
+		_NODISCARD bool operator==(const LeakGroupKey& other) const noexcept {
+			return file == other.file && line == other.line && blockSize == other.blockSize;
+		};
+	};
+	struct LeakGroupKeyHash {			// Hash of a top leaks report group
+		_NODISCARD size_t operator()(const LeakGroupKey& key) const noexcept {
+			size_t hash = std::hash<const char*>()(key.file);
+			hash ^= std::hash<int32_t>()(key.line) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+			hash ^= std::hash<size_t>()(key.blockSize) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+			return hash;
+		};
+	};
+	using LeakGroupData		= typename std::unordered_map<LeakGroupKey, LeakGroup, LeakGroupKeyHash, std::equal_to<LeakGroupKey>,
+														 InternalAllocator<std::pair<const LeakGroupKey, LeakGroup>>>;
+	static constexpr size_t MAX_HOOKS = 16;
+	static constexpr size_t SIZE_LIMIT = ~static_cast<size_t>(0);
+	static constexpr size_t SMALL_BLOCK_MAX_SIZE = 0xFFFFFFFFu;	// Size limit of the blocks counted per callsite
+	static constexpr size_t SIZE_CLASS_COUNT = 48;			// Power of two size classes of the startup profile
+	static constexpr size_t EPOCH_FOLD_BATCH = 32;			// Deferred changes folded back per tracking operation
+	static constexpr size_t MAX_EPOCH_DELTA = 64 * 1024;	// Deferred changes beyond which new readers wait for the pinned ones to leave
+	static constexpr uint32_t OVERHEAD_SAMPLE_RATE = 1024;		// One tracking operation out of this many is timed (power of two)
+	struct HookList;					// Immutable list of allocation/deallocation hooks
+	enum class EraseResult { Erased, SmallBlock, OverflowBlock, Unknown, Mismatch };
 	using TrackingReport	= typename std::vector<StringData>;
 
-#ifdef _MTP_THREADSAFETY
-	using MutexObj			= typename std::recursive_mutex;
-	using MutexLockGuard	= typename std::lock_guard<MutexObj>;
-#endif // _MTP_THREADSAFETY
 
 public:
 	// Constructor
-	MemTrackifyPlus() {
+	MemTrackifyPlus()
+		: allocTrackData_(AllocTrackData::allocator_type(overheadBytes_)), debugTrackData_(overheadBytes_),
+		  epochDelta_(EpochDeltaData::allocator_type(overheadBytes_)), smallBlocks_(overheadBytes_), smallBlockSet_(overheadBytes_),
+		  overflowSlabs_(overheadBytes_), trackedFilter_(overheadBytes_)
+#ifdef _MTP_GROWTH_TRACKING
+		  , growthTracker_(overheadBytes_)
+#endif // _MTP_GROWTH_TRACKING
+		  {
 		allocTrackData_.reserve(64);
+		runtimeOptions_ = parseRuntimeOptions(std::getenv("MTP_OPTIONS"));
+		if (runtimeOptions_.profilePath[0] != '\0' && readStartupProfile(runtimeOptions_.profilePath, startupProfile_))
+			presizeTables(startupProfile_);
+		isTrackingEnabled_.store(getTrackingEnv(runtimeOptions_.isTrackingEnabled), std::memory_order_relaxed);
 		isTrackerInitialized_ = true;
+		applyRuntimeOptions();
 	};
 
 	// Destructor
 	~MemTrackifyPlus() {
+		shutdown();
+
+		// Release the hook lists (no hook can run on a destroyed tracker)
+		while (retiredHooks_ != nullptr) {
+			HookList* retired = retiredHooks_;
+			retiredHooks_ = retired->nextRetired;
+			freeHookList(retired);
+		}
+	};
+
+private:
+	friend class GlobalMemTracker;
+
+	// Print the termination reports and execute garbage collection (once), the tracker stays usable afterwards
+	// Note: The global tracker is never destroyed, this runs at exit instead (see GlobalMemTracker::ExitGuard)
+	void shutdown(void) {
+		if (isShutdown_.exchange(true)) return;
+
+#ifdef _MTP_THREADSAFETY
+		// Finish the pending asynchronous reports first
+		asyncReportWriter_.stop();
+#endif // _MTP_THREADSAFETY
+
 #ifdef _MTP_CONSOLE_REPORT_ON_TERMINATION
 		this->printTrackingReport(std::cout);
 #endif // _MTP_CONSOLE_REPORT_ON_TERMINATION
 
+		// Print the termination report requested by MTP_OPTIONS
+		if (runtimeOptions_.reportFormat != 0) printRuntimeReport();
+
+		// Save the allocation profile for the next run
+		if (runtimeOptions_.profilePath[0] != '\0') (void)writeStartupProfile(runtimeOptions_.profilePath);
+
+		// Unpublish the hook lists, they are only retired: other threads may still be running hooks from them at exit
+		// Note: The global tracker is never destroyed, so its lists are never released (as the flight recorder rings)
+		publishHookList(allocHooks_, nullptr);
+		publishHookList(freeHooks_, nullptr);
+
+#ifdef _MTP_THREADSAFETY
+		MutexLockGuard lock(myMutex_);
+#endif // _MTP_THREADSAFETY
+
+		// Apply any tracking changes deferred by a pinned epoch (unless readers still pin the table)
+		if (epochReaders_ == 0) foldEpochDelta();
+
 		// Automatically execute garbage collection at termination
-		if (isMemoryLeak()) {
+		if (liveCount_ != 0) {
 #ifdef _MTP_CONSOLE_REPORT_ON_TERMINATION
 			std::cout << "\n--- Executing garbage collection ---\n";
 #endif // _MTP_CONSOLE_REPORT_ON_TERMINATION
-			for (const auto& info : allocTrackData_) {
-				if (info.first) {
+			forEachLiveLocked([](const AllocRecord& record) {
 #ifdef _MTP_CONSOLE_REPORT_ON_TERMINATION
-					std::cout << "  Freed " << info.second.size << " bytes at " << info.first << ".\n";
+				std::cout << "  Freed " << record.size << " bytes at " << record.address << ".\n";
 #endif // _MTP_CONSOLE_REPORT_ON_TERMINATION
-					std::free(info.first);  // Clean up
-				}
-			}
+				AllocatorBackend::deallocate(record.address);  // Clean up
+			});
+			isCollected_ = true;
 
 			// Clean up the tracking data itself
-			allocTrackData_.clear();
+			// Note: A table pinned by readers is only read by them, the last one clears it
+			epochDelta_.clear();
+			if (epochReaders_ != 0) isTableCollected_ = true;
+			else clearCollectedTable();
+			liveCount_ = liveBytes_ = 0;
 		}
 	};
 
@@ -256,8 +760,19 @@ public:
 	_NODISCARD static inline void* smartAlloc(size_t size, bool isArray);
 #else
 	_NODISCARD static inline void* smartAlloc(size_t size, const char* file, int line, bool isArray);
+	// Name of a caller ("0x..." return address), used as the callsite of the plain operator new (e.g. the STL containers)
+	_NODISCARD static inline const char* getCallerName(const void* caller) noexcept;
 #endif // !_MTP_DEBUG
 	static inline void smartFree(void* ptr, bool isArray);
+
+	// Define static functions for batch allocation/deallocation (a single tracker critical section per batch)
+	// Note: smartAllocBatch() is all or nothing, it throws std::bad_alloc after freeing the blocks already allocated
+#ifndef _MTP_DEBUG
+	static inline void smartAllocBatch(const size_t* sizes, void** out, size_t count, bool isArray);
+#else
+	static inline void smartAllocBatch(const size_t* sizes, void** out, size_t count, const char* file, int line, bool isArray);
+#endif // !_MTP_DEBUG
+	static inline void smartFreeBatch(void* const* ptrs, size_t count, bool isArray);
 	static inline void smartDealloc(void* ptr, bool isArray) { smartFree(ptr, isArray); };
 
 private:
@@ -267,27 +782,47 @@ private:
 		if (size == 0) return nullptr;
 
 		// Skip re-entry during tracker map initialization
-		thread_local bool isInReqTrackAlloc = false;
-		if (isInReqTrackAlloc) return std::malloc(size);
+		bool& isInReqTrackAlloc = getReentryFlag();
+		if (isInReqTrackAlloc) return AllocatorBackend::allocate(size);
+
+#ifdef _MTP_SMALL_OBJECT_ALLOCATOR
+		// Small objects are served by the slab allocator and tracked by the bitmap of their slab
+		if (size <= SmallObjectAllocator::MAX_SIZE) {
+			void* ptr = SmallObjectAllocator::allocate(size);
+			if (ptr) return ptr;
+		}
+#endif // _MTP_SMALL_OBJECT_ALLOCATOR
+
+		// Small blocks are only counted per callsite, so are the blocks allocated once the tracker memory limit is reached
+		if (isTableFull_.load(std::memory_order_relaxed) && size <= SMALL_BLOCK_MAX_SIZE) return allocOverflowBlock(size, file, line);
+		if (size < smallBlockThreshold_.load(std::memory_order_relaxed)) return allocSmallBlock(size, file, line);
 
-		// Ensure the flag is automatically reset
-		AllocGuard allocGuard(isInReqTrackAlloc);
+		void* ptr = nullptr;
+		bool isTracked = false;
+		{
+			// Ensure the flag is automatically reset
+			AllocGuard allocGuard(isInReqTrackAlloc);
 
-		// Allocate memory block
-		void* ptr = std::malloc(size);
-		if (!ptr) throw std::bad_alloc();
+			// Allocate memory block
+			ptr = AllocatorBackend::allocate(size);
+			if (!ptr) throw std::bad_alloc();
 
+			OverheadSampler sampler(*this);
 #ifdef _MTP_THREADSAFETY
-		MutexLockGuard _lock(myMutex_);
+			MutexLockGuard _lock(myMutex_);
 #endif // _MTP_THREADSAFETY
 
-		// Track allocation info
-		if (ptr && (reinterpret_cast<uintptr_t>(ptr) > 0x10000)
-			/* only track when the track map is initialized */
-			&& isTrackerInitialized_.load(std::memory_order_acquire)) {
-			allocTrackData_.insert(AllocTrackObj(ptr, { size, isArray }));
-			debugTrackData_.insert(DebugTrackObj(ptr, { file, line }));
+			// Track allocation info
+			if (ptr && (reinterpret_cast<uintptr_t>(ptr) > 0x10000)
+				/* only track when the track map is initialized */
+				&& isTrackerInitialized_.load(std::memory_order_acquire)) {
+				trackInsert(ptr, { size, isArray }, { file, line });
+				isTracked = true;
+			}
 		}
+
+		// Notify the subscribers (outside of the tracker lock)
+		if (isTracked) invokeHooks(allocHooks_, ptr, size, isArray, { file, line });
 		return ptr;
 	};
 
@@ -296,135 +831,3139 @@ private:
 		// Not a valid pointer
 		if (!ptr) return;
 
+		AllocRecord erased;
+		EraseResult result = EraseResult::Unknown;
+		{
+			OverheadSampler sampler(*this);
 #ifdef _MTP_THREADSAFETY
-		MutexLockGuard lock(myMutex_);
+			MutexLockGuard lock(myMutex_);
+#endif // _MTP_THREADSAFETY
+
+			// Check the allocation info
+			result = releaseBlock(ptr, isArray, erased);
+		}
+
+		// Notify the subscribers (outside of the tracker lock) and free memory
+		freeReleasedBlock(ptr, isArray, result, erased);
+	};
+
+	// Request a batch of memory allocations, tracked under a single critical section
+	void reqTrackAllocBatch(const size_t* sizes, void** out, size_t count, const char* file, int line, bool isArray) {
+		bool& isInReqTrackAlloc = getReentryFlag();
+		if (isInReqTrackAlloc) {
+			allocUntrackedBatch(sizes, out, count);
+			return;
+		}
+
+		// Allocate all the blocks first, outside of the tracker lock (small blocks get their header)
+		// Note: Once the tracker memory limit is reached, the blocks come from the overflow slabs under the lock
+		const size_t smallThreshold = smallBlockThreshold_.load(std::memory_order_relaxed);
+		const bool isTableFull = isTableFull_.load(std::memory_order_relaxed);
+		auto isOverflowBlock = [isTableFull](size_t size) {
+			return isTableFull && size <= SMALL_BLOCK_MAX_SIZE;
+		};
+		auto isSmallBlock = [smallThreshold, isTableFull](size_t size) {
+			return !isTableFull && size < smallThreshold;
+		};
+		auto isSlabBlock = [sizes, out](size_t idx) {
+#ifdef _MTP_SMALL_OBJECT_ALLOCATOR
+			return (sizes[idx] <= SmallObjectAllocator::MAX_SIZE) && SmallObjectAllocator::owns(out[idx]);
+#else
+			(void)sizes; (void)out; (void)idx;
+			return false;
+#endif // _MTP_SMALL_OBJECT_ALLOCATOR
+		};
+		auto freeBlocks = [&](size_t end) {
+			for (size_t prev = 0; prev < end; ++prev) {
+#ifdef _MTP_SMALL_OBJECT_ALLOCATOR
+				if (isSlabBlock(prev)) SmallObjectAllocator::deallocate(out[prev]);
+				else
+#endif // _MTP_SMALL_OBJECT_ALLOCATOR
+				if (out[prev] != nullptr)
+					AllocatorBackend::deallocate(isSmallBlock(sizes[prev]) ? static_cast<void*>(static_cast<SmallBlockHeader*>(out[prev]) - 1) : out[prev]);
+				out[prev] = nullptr;
+			}
+		};
+		size_t smallCount = 0;
+		for (size_t idx = 0; idx < count; ++idx) {
+			const size_t size = sizes[idx];
+			out[idx] = nullptr;
+			if (size == 0) continue;
+#ifdef _MTP_SMALL_OBJECT_ALLOCATOR
+			if (size <= SmallObjectAllocator::MAX_SIZE && (out[idx] = SmallObjectAllocator::allocate(size)) != nullptr) continue;
+#endif // _MTP_SMALL_OBJECT_ALLOCATOR
+			if (isOverflowBlock(size)) continue;
+			if (isSmallBlock(size)) {
+				SmallBlockHeader* header = static_cast<SmallBlockHeader*>(AllocatorBackend::allocate(sizeof(SmallBlockHeader) + size));
+				if (header != nullptr) out[idx] = header + 1;
+				++smallCount;
+			}
+			else {
+				out[idx] = AllocatorBackend::allocate(size);
+			}
+			if (out[idx] == nullptr) {
+				freeBlocks(idx);
+				throw std::bad_alloc();
+			}
+		}
+
+		// Track them in one pass
+		bool isTracked = false;
+		{
+			AllocGuard allocGuard(isInReqTrackAlloc);
+			OverheadSampler sampler(*this);
+#ifdef _MTP_THREADSAFETY
+			MutexLockGuard lock(myMutex_);
 #endif // _MTP_THREADSAFETY
 
-		// Check the allocation info and free memory
-		if (!isMemoryLeak()) return;
-		auto it = allocTrackData_.find(ptr);
-		if (it != allocTrackData_.end())
-			if (it->first == ptr && it->second.isArray == isArray) {
-				allocTrackData_.erase(it);		// Remove the entry
-				std::free(ptr);					// Default: Free memory
+			// Grow the tables once for the whole batch
+			isTracked = isTrackerInitialized_.load(std::memory_order_acquire);
+			if (isTracked && epochReaders_ == 0) {
+				TableMutationGuard mutationGuard(isTableMutating_, isDumpingTable_);
+				allocTrackData_.reserve(allocTrackData_.size() + count);
+				debugTrackData_.reserve(allocTrackData_.size() + count);
+			}
+
+			// Small blocks are only handed out once they are known to carry a header
+			if (smallCount != 0) {
+				try { reserveSmallBlocks(smallCount); }
+				catch (...) {
+					freeBlocks(count);
+					throw;
+				}
+			}
+
+			// Overflow blocks are taken from their slabs (all or nothing as well)
+			if (isTableFull) {
+				for (size_t idx = 0; idx < count; ++idx) {
+					if (out[idx] != nullptr || sizes[idx] == 0 || !isOverflowBlock(sizes[idx])) continue;
+					try { out[idx] = recordOverflowBlock(sizes[idx], file, line); }
+					catch (...) {
+						for (size_t prev = 0; prev < idx; ++prev) {
+							if (out[prev] == nullptr || isSlabBlock(prev) || !isOverflowBlock(sizes[prev])) continue;
+							(void)freeOverflowBlock(out[prev]);
+							out[prev] = nullptr;
+						}
+						freeBlocks(count);
+						throw;
+					}
+				}
+			}
+			for (size_t idx = 0; idx < count; ++idx) {
+				if (idx + 1 < count && out[idx + 1] != nullptr) trackedFilter_.prefetch(out[idx + 1]);
+				if (out[idx] == nullptr || isSlabBlock(idx) || isOverflowBlock(sizes[idx])) continue;
+				if (isSmallBlock(sizes[idx]))
+					recordSmallBlock(out[idx], sizes[idx], file, line);
+				else if (isTracked && (reinterpret_cast<uintptr_t>(out[idx]) > 0x10000))
+					trackInsert(out[idx], { sizes[idx], isArray }, { file, line });
 			}
+		}
+
+		// Notify the subscribers (outside of the tracker lock)
+		if (!isTracked) return;
+		for (size_t idx = 0; idx < count; ++idx)
+			if (out[idx] != nullptr && !isSmallBlock(sizes[idx]) && !isOverflowBlock(sizes[idx]) && !isSlabBlock(idx) && (reinterpret_cast<uintptr_t>(out[idx]) > 0x10000))
+				invokeHooks(allocHooks_, out[idx], sizes[idx], isArray, { file, line });
 	};
 
-	// Print memory tracking info
-	void printTrackingInfo(const AllocTrackObj& allocTrackObj, std::ostream& os, bool newLine) const noexcept {
-		os << "Leaked: " << allocTrackObj.second.size << " bytes "
-			<< (allocTrackObj.second.isArray ? "of an array " : "") << "at " << allocTrackObj.first;
-#ifdef _MTP_DEBUG
-		auto debugInfo = debugTrackData_.get(allocTrackObj.first);
-		if (debugInfo != nullptr) {
-			os << " in " << ((debugInfo->file != nullptr) ? debugInfo->file : "unknown file");
-			if (debugInfo->line != -1)
-				os << " (line:" << debugInfo->line << ")";
-			else
-				os << " (line: unknown)";
+	// Request a batch of memory deallocations, untracked under a single critical section (per chunk of blocks)
+	void reqTrackDeallocBatch(void* const* ptrs, size_t count, bool isArray) {
+		static constexpr size_t CHUNK_SIZE = 256;
+		enum class FreeAction : uint8_t { None, Lookup, Untracked };
+		FreeAction actions[CHUNK_SIZE];
+		EraseResult results[CHUNK_SIZE];
+		AllocRecord erased[CHUNK_SIZE];
+		const bool isEnabled = isTrackingEnabled_.load(std::memory_order_relaxed);
+		for (size_t first = 0; first < count; first += CHUNK_SIZE) {
+			const size_t chunkCount = (count - first < CHUNK_SIZE) ? count - first : CHUNK_SIZE;
+			void* const* chunk = ptrs + first;
+
+			// Only look up the blocks that may have been tracked, the others are freed without taking the tracker lock
+			size_t candidateCount = 0;
+			for (size_t idx = 0; idx < chunkCount; ++idx) {
+				actions[idx] = FreeAction::None;
+				if (chunk[idx] == nullptr) continue;
+#ifdef _MTP_SMALL_OBJECT_ALLOCATOR
+				if (SmallObjectAllocator::deallocate(chunk[idx])) continue;
+#endif // _MTP_SMALL_OBJECT_ALLOCATOR
+				actions[idx] = mayBeTracked(chunk[idx]) ? FreeAction::Lookup : FreeAction::Untracked;
+				if (actions[idx] == FreeAction::Lookup) ++candidateCount;
+			}
+			if (candidateCount != 0) {
+				OverheadSampler sampler(*this);
+#ifdef _MTP_THREADSAFETY
+				MutexLockGuard lock(myMutex_);
+#endif // _MTP_THREADSAFETY
+				for (size_t idx = 0; idx < chunkCount; ++idx)
+					if (actions[idx] == FreeAction::Lookup) results[idx] = releaseBlock(chunk[idx], isArray, erased[idx]);
+			}
+
+			// Notify the subscribers (outside of the tracker lock) and free memory
+			for (size_t idx = 0; idx < chunkCount; ++idx) {
+				if (actions[idx] == FreeAction::None) continue;
+				if (actions[idx] == FreeAction::Lookup)
+					freeReleasedBlock(chunk[idx], isArray, results[idx], erased[idx]);
+				else if (isEnabled)
+					freeUntracked(chunk[idx], isArray);
+				else
+					AllocatorBackend::deallocate(chunk[idx]);
+			}
 		}
-#endif // _MTP_DEBUG
-		os << (newLine ? ".\n" : ".");
 	};
 
-public:
-	// Get size of the allocation tracker (in bytes)
-	_NODISCARD size_t getTrackerSize(void) const {
-		size_t size = 0;
-		if (isMemoryLeak())
-			for (const auto& info : allocTrackData_) {
-				size += sizeof(info.first);
-				size += sizeof(info.second);
+	// Allocate a batch of untracked blocks (all or nothing)
+	static void allocUntrackedBatch(const size_t* sizes, void** out, size_t count) {
+		for (size_t idx = 0; idx < count; ++idx) {
+			out[idx] = (sizes[idx] != 0) ? AllocatorBackend::allocate(sizes[idx]) : nullptr;
+			if (sizes[idx] != 0 && out[idx] == nullptr) {
+				for (size_t prev = 0; prev < idx; ++prev) {
+					AllocatorBackend::deallocate(out[prev]);
+					out[prev] = nullptr;
+				}
+				throw std::bad_alloc();
 			}
+		}
+	};
 
-		return size;
+	// Flag of the calling thread, set while the tracker itself allocates
+	_NODISCARD static bool& getReentryFlag(void) noexcept {
+		thread_local bool isInReqTrackAlloc = false;
+		return isInReqTrackAlloc;
 	};
 
-	// Get total tracked allocated memory sizes (in bytes)
-	_NODISCARD size_t getMemorySize(void) const {
-		size_t size = 0;
-		if (isMemoryLeak())
-			for (const auto& info : allocTrackData_)
-				size += info.second.size;
+	// Untrack a block being freed, return what it was (the caller holds the tracker lock)
+	_NODISCARD EraseResult releaseBlock(Address ptr, bool isArray, AllocRecord& erased) {
+		EraseResult result = (liveCount_ != 0) ? trackErase(ptr, isArray, &erased) : EraseResult::Unknown;
+		if (result == EraseResult::Unknown && smallBlocks_.getLiveCount() != 0) result = freeSmallBlock(ptr);
+		if (result == EraseResult::Unknown && overflowSummary_.liveCount != 0) result = freeOverflowBlock(ptr);
+#ifdef _MTP_FLIGHT_RECORDER
+		if (result != EraseResult::Erased)
+			FlightRecorder::record(ptr, 0, {}, FlightRecorder::FLAG_FREE | (isArray ? static_cast<uint32_t>(FlightRecorder::FLAG_ARRAY) : 0u));
+#endif // _MTP_FLIGHT_RECORDER
+		return result;
+	};
 
-		return size;
+	// Notify the subscribers and free a block released by releaseBlock() (outside of the tracker lock)
+	void freeReleasedBlock(void* ptr, bool isArray, EraseResult result, const AllocRecord& erased) {
+		if (result == EraseResult::Erased) {
+			invokeHooks(freeHooks_, ptr, erased.size, isArray, erased.callsite);
+			AllocatorBackend::deallocate(ptr);		// Default: Free memory
+		}
+		else if (result == EraseResult::SmallBlock) {
+			AllocatorBackend::deallocate(static_cast<SmallBlockHeader*>(ptr) - 1);
+		}
+		// Overflow blocks were given back to their slab by releaseBlock()
+		else if (result == EraseResult::Unknown && !isCollected_) {
+			AllocatorBackend::deallocate(ptr);		// Untracked block (e.g. allocated while tracking was disabled)
+		}
 	};
 
-	// Get the number of tracking allocated memory blocks
-	_NODISCARD size_t getPtrCount(void) const {
+	// Head of the typed object pool registry
+	_NODISCARD static std::atomic<PoolRegistration*>& pools(void) noexcept {
+		static std::atomic<PoolRegistration*> poolList(nullptr);
+		return poolList;
+	};
+
+	// Count the live objects of the registered pools (and their bytes)
+	static void countPoolObjects(size_t& count, size_t& bytes) {
+		std::pair<size_t*, size_t*> counters(&count, &bytes);
+		for (PoolRegistration* pool = pools().load(std::memory_order_acquire); pool != nullptr; pool = pool->next) {
+			pool->forEachLive([](const void*, size_t size, void* context) {
+				auto* counters = static_cast<std::pair<size_t*, size_t*>*>(context);
+				++*counters->first;
+				*counters->second += size;
+			}, &counters);
+		}
+	};
+
+	// Bytes of the heap blocks per category, of the tracker storage not owned by a tracker instance
+	_NODISCARD static std::atomic<size_t>* overheadCounters(void) noexcept {
+		static std::atomic<size_t> counters[OVERHEAD_CATEGORY_COUNT];
+		return counters;
+	};
+
+	// Account a heap block of the tracker's own storage
+	static void addOverhead(OverheadCategory category, size_t bytes) noexcept {
+		overheadCounters()[static_cast<size_t>(category)].fetch_add(bytes, std::memory_order_relaxed);
+	};
+	static void subOverhead(OverheadCategory category, size_t bytes) noexcept {
+		overheadCounters()[static_cast<size_t>(category)].fetch_sub(bytes, std::memory_order_relaxed);
+	};
+
+	// Estimate the heap cost of a block (requested size, plus a size word, rounded to the 16 bytes granularity)
+	_NODISCARD static constexpr size_t getHeapBlockCost(size_t size) noexcept {
+		return (size + sizeof(size_t) + 15) & ~static_cast<size_t>(15);
+	};
+
+	// Per-address memory of this tracker, capped by the tracker memory limit: the tracking table, the debug tracking info,
+	// the small block set and the small block headers (the caller holds the tracker lock)
+	_NODISCARD size_t getTableMemory(void) const noexcept {
+		return overheadBytes_[static_cast<size_t>(OverheadCategory::Table)].load(std::memory_order_relaxed)
+			+ overheadBytes_[static_cast<size_t>(OverheadCategory::DebugInfo)].load(std::memory_order_relaxed)
+			+ smallBlockSet_.getMemory() + getSmallBlockHeaderMemory();
+	};
+	_NODISCARD size_t getSmallBlockHeaderMemory(void) const noexcept {
+		return (smallBlocks_.getLiveCount() - overflowSummary_.liveCount) * sizeof(SmallBlockHeader);
+	};
+
+	// Switch to the overflow slabs once the per-address memory reaches the limit, and back below it (the caller holds the tracker lock)
+	void updateTableFull(void) noexcept {
+		const bool isTableFull = (trackerMemoryLimit_ != 0) && (getTableMemory() >= trackerMemoryLimit_);
+		if (isTableFull != isTableFull_.load(std::memory_order_relaxed)) isTableFull_.store(isTableFull, std::memory_order_relaxed);
+	};
+
+	// Index of the power of two size class of a block (class i holds the sizes in (2^(i-1), 2^i])
+	_NODISCARD static size_t getSizeClassIndex(size_t size) noexcept {
+		size_t index = 0;
+		for (size_t bound = 1; bound < size && index < SIZE_CLASS_COUNT - 1; bound <<= 1) ++index;
+		return index;
+	};
+
+	// Reserve the tables for the peak of a previous run, so that startup allocations never wait on a rehash
+	void presizeTables(const StartupProfile& profile) {
+		const size_t peakCount = static_cast<size_t>(profile.peakLiveCount);
+		if (peakCount <= allocTrackData_.size()) return;
+		allocTrackData_.reserve(peakCount);
+		debugTrackData_.reserve(peakCount);
+	};
+
+	// Allocate a small block behind a header, only counted in its callsite/size class group
+	_NODISCARD void* allocSmallBlock(size_t size, const char* file, int line) {
+		SmallBlockHeader* header = static_cast<SmallBlockHeader*>(AllocatorBackend::allocate(sizeof(SmallBlockHeader) + size));
+		if (!header) throw std::bad_alloc();
+		void* ptr = header + 1;
+
+		OverheadSampler sampler(*this);
 #ifdef _MTP_THREADSAFETY
 		MutexLockGuard lock(myMutex_);
 #endif // _MTP_THREADSAFETY
-		return allocTrackData_.size();
+		try { reserveSmallBlocks(1); }
+		catch (...) {
+			AllocatorBackend::deallocate(header);
+			throw;
+		}
+		recordSmallBlock(ptr, size, file, line);
+		return ptr;
 	};
 
-	// Check if there are any allocated memory blocks in use or not yet freed
-	_NODISCARD bool isMemoryLeak(void) const {
+	// Allocate a block from the overflow slabs, only counted in its callsite/size class group
+	_NODISCARD void* allocOverflowBlock(size_t size, const char* file, int line) {
+		OverheadSampler sampler(*this);
 #ifdef _MTP_THREADSAFETY
 		MutexLockGuard lock(myMutex_);
 #endif // _MTP_THREADSAFETY
-		return (!allocTrackData_.empty());
+		return recordOverflowBlock(size, file, line);
 	};
 
-	// Get memory tracking report data (as an array of string)
-	_NODISCARD TrackingReport getTrackingReport(void) const noexcept {
-		if (isInReporting_.exchange(true)) { return {}; }
-		TrackingReport report;
-		if (isMemoryLeak()) {
-			report.reserve(getPtrCount());
-			for (const auto& info : allocTrackData_) {
-				StringStreamData oss;
-				printTrackingInfo(info, oss, false);
-				report.push_back(oss.str());
-			}
+	// Reserve the storage of the small block counters for new blocks (the caller holds the tracker lock)
+	void reserveSmallBlocks(size_t count) {
+		smallBlocks_.reserve();
+		smallBlockSet_.reserve(count);
+	};
+
+	// Count a small block and fill in its header (the caller holds the tracker lock and reserved its storage)
+	void recordSmallBlock(Address ptr, size_t size, const char* file, int line) noexcept {
+		SmallBlockHeader* header = static_cast<SmallBlockHeader*>(ptr) - 1;
+		smallBlockSet_.insert(ptr);
+		header->groupIndex = smallBlocks_.add(file, line, size);
+		if (smallBlocks_.getLiveCount() > peakSmallCount_) peakSmallCount_ = smallBlocks_.getLiveCount();
+		++sizeClassCounts_[getSizeClassIndex(size)];
+		header->size = static_cast<uint32_t>(size);
+		widenTrackedRange(ptr, size);
+		trackedFilter_.insert(ptr);
+		updateTableFull();
+	};
+
+	// Uncount a small block if the pointer is a live small block (the caller holds the tracker lock)
+	// Note: The header right before the block is only read once the block is found in the small block set
+	_NODISCARD EraseResult freeSmallBlock(Address ptr) noexcept {
+		if (!smallBlockSet_.erase(ptr)) return EraseResult::Unknown;
+		SmallBlockHeader* header = static_cast<SmallBlockHeader*>(ptr) - 1;
+		smallBlocks_.remove(header->groupIndex, header->size);
+		trackedFilter_.erase(ptr);
+		if (liveCount_ == 0 && smallBlocks_.getLiveCount() == 0) resetTrackedRange();
+		updateTableFull();
+		return EraseResult::SmallBlock;
+	};
+
+	// Take a block from the overflow slabs and count it (the caller holds the tracker lock)
+	_NODISCARD void* recordOverflowBlock(size_t size, const char* file, int line) {
+		smallBlocks_.reserve();
+		overflowSlabs_.reserve();
+		const uint32_t groupIndex = smallBlocks_.add(file, line, size);
+		void* ptr = overflowSlabs_.allocate(size, groupIndex);
+		if (ptr == nullptr) {
+			smallBlocks_.remove(groupIndex, size);
+			throw std::bad_alloc();
 		}
-		isInReporting_ = false;
-		return report;
+		if (smallBlocks_.getLiveCount() > peakSmallCount_) peakSmallCount_ = smallBlocks_.getLiveCount();
+		++sizeClassCounts_[getSizeClassIndex(size)];
+		++overflowSummary_.liveCount;
+		overflowSummary_.liveBytes += size;
+		++overflowSummary_.totalCount;
+		overflowSummary_.totalBytes += size;
+		widenTrackedRange(ptr, size);
+		trackedFilter_.insert(ptr);
+		return ptr;
 	};
 
-	// Print memory tracking report data (to file/console, ...)
-	void printTrackingReport(std::ostream& os) const noexcept {
-		if (isMemoryLeak()) {
-			os << "\n--- Memory Leaks Detected ---\n";
-			for (const auto& info : allocTrackData_) {
-				printTrackingInfo(info, os, true);
+	// Uncount an overflow block and give it back to its slab if the pointer is a live overflow block (the caller holds the tracker lock)
+	_NODISCARD EraseResult freeOverflowBlock(Address ptr) noexcept {
+		uint32_t groupIndex = 0;
+		uint32_t size = 0;
+		if (!overflowSlabs_.release(ptr, groupIndex, size)) return EraseResult::Unknown;
+		--overflowSummary_.liveCount;
+		overflowSummary_.liveBytes -= size;
+		smallBlocks_.remove(groupIndex, size);
+		trackedFilter_.erase(ptr);
+		if (liveCount_ == 0 && smallBlocks_.getLiveCount() == 0) resetTrackedRange();
+		return EraseResult::OverflowBlock;
+	};
+
+	// Record a new live allocation (the caller holds the tracker lock)
+	void trackInsert(Address ptr, const AllocInfo& allocInfo, const DebugInfo& debugInfo) {
+		if (epochReaders_ != 0) {
+			// The table is frozen for pinned readers, defer the change
+			epochDelta_[ptr] = { allocInfo, debugInfo, true };
+		}
+		else {
+			if (!epochDelta_.empty()) foldEpochDeltaStep(ptr);
+			TableMutationGuard mutationGuard(isTableMutating_, isDumpingTable_);
+			allocTrackData_[ptr] = allocInfo;
+			debugTrackData_.insert(ptr, debugInfo.file, debugInfo.line);
+		}
+		++liveCount_;
+		liveBytes_ += allocInfo.size;
+		if (liveCount_ > peakLiveCount_) peakLiveCount_ = liveCount_;
+		++sizeClassCounts_[getSizeClassIndex(allocInfo.size)];
+		updateTableFull();
+		widenTrackedRange(ptr, allocInfo.size);
+		trackedFilter_.insert(ptr);
+		onTrackInsert(ptr, allocInfo, debugInfo);
+	};
+
+	// Remove a live allocation (the caller holds the tracker lock)
+	_NODISCARD EraseResult trackErase(Address ptr, bool isArray, AllocRecord* erased = nullptr) {
+		AllocInfo allocInfo = {};
+		DebugInfo debugInfo;
+		if (epochReaders_ != 0) {
+			// The table is frozen for pinned readers, record a tombstone instead
+			auto deltaIt = epochDelta_.find(ptr);
+			if (deltaIt != epochDelta_.end()) {
+				if (!deltaIt->second.isLive) return EraseResult::Unknown;
+				if (deltaIt->second.allocInfo.isArray != isArray) return EraseResult::Mismatch;
+				allocInfo = deltaIt->second.allocInfo;
+				debugInfo = deltaIt->second.debugInfo;
+				deltaIt->second.isLive = false;
+			}
+			else {
+				auto it = isTableCollected_ ? allocTrackData_.end() : allocTrackData_.find(ptr);
+				if (it == allocTrackData_.end()) return EraseResult::Unknown;
+				if (it->second.isArray != isArray) return EraseResult::Mismatch;
+				allocInfo = it->second;
+				if (const DebugInfo* info = debugTrackData_.get(ptr)) debugInfo = *info;
+				epochDelta_[ptr] = { allocInfo, debugInfo, false };
 			}
 		}
 		else {
-			os << "\nNo memory leaks detected.\n";
+			if (!epochDelta_.empty()) foldEpochDeltaStep(ptr);
+			auto it = allocTrackData_.find(ptr);
+			if (it == allocTrackData_.end()) return EraseResult::Unknown;
+			if (it->second.isArray != isArray) return EraseResult::Mismatch;
+			allocInfo = it->second;
+			if (const DebugInfo* info = debugTrackData_.get(ptr)) debugInfo = *info;
+			TableMutationGuard mutationGuard(isTableMutating_, isDumpingTable_);
+			allocTrackData_.erase(it);		// Remove the entry
+			debugTrackData_.erase(ptr);
 		}
+		if (--liveCount_ == 0 && smallBlocks_.getLiveCount() == 0) resetTrackedRange();
+		liveBytes_ -= allocInfo.size;
+		trackedFilter_.erase(ptr);
+		updateTableFull();
+		onTrackErase(ptr, allocInfo, debugInfo);
+		if (erased != nullptr) *erased = { ptr, allocInfo.size, allocInfo.isArray, debugInfo };
+		return EraseResult::Erased;
 	};
 
-private:
-	// No copyable
+	// Replace the callsite of a live allocation, return false if it is not tracked (the caller holds the tracker lock)
+	_NODISCARD bool trackRetag(Address ptr, const DebugInfo& debugInfo) {
+		if (epochReaders_ != 0) {
+			// The table is frozen for pinned readers, defer the change
+			auto deltaIt = epochDelta_.find(ptr);
+			if (deltaIt != epochDelta_.end()) {
+				if (!deltaIt->second.isLive) return false;
+				deltaIt->second.debugInfo = debugInfo;
+				return true;
+			}
+			auto it = isTableCollected_ ? allocTrackData_.end() : allocTrackData_.find(ptr);
+			if (it == allocTrackData_.end()) return false;
+			epochDelta_[ptr] = { it->second, debugInfo, true };
+			return true;
+		}
+		if (!epochDelta_.empty()) foldEpochDeltaStep(ptr);
+		if (allocTrackData_.find(ptr) == allocTrackData_.end()) return false;
+		TableMutationGuard mutationGuard(isTableMutating_, isDumpingTable_);
+		debugTrackData_.insert(ptr, debugInfo.file, debugInfo.line);
+		return true;
+	};
+
+	// Extend the address range covering the live tracked blocks (the caller holds the tracker lock)
+	void widenTrackedRange(Address ptr, size_t size) noexcept {
+		const uintptr_t first = reinterpret_cast<uintptr_t>(ptr);
+		if (first < trackedRangeBegin_.load(std::memory_order_relaxed))
+			trackedRangeBegin_.store(first, std::memory_order_relaxed);
+		if (first + size > trackedRangeEnd_.load(std::memory_order_relaxed))
+			trackedRangeEnd_.store(first + size, std::memory_order_relaxed);
+	};
+
+	// Empty the tracked address range once no tracked block is live (the caller holds the tracker lock)
+	void resetTrackedRange(void) noexcept {
+		trackedRangeBegin_.store(~uintptr_t(0), std::memory_order_relaxed);
+		trackedRangeEnd_.store(0, std::memory_order_relaxed);
+	};
+
+	// Check if a block may be tracked: it lies in the tracked address range and the filter does not rule it out (lock-free)
+	// Note: A tracked block is always reported, its insertion happened before the pointer was handed out
+	_NODISCARD bool mayBeTracked(const void* ptr) const noexcept {
+		const uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+		return (address >= trackedRangeBegin_.load(std::memory_order_relaxed))
+			&& (address < trackedRangeEnd_.load(std::memory_order_relaxed))
+			&& trackedFilter_.mayContain(ptr);
+	};
+
+	// Free a block which is not tracked, without taking the tracker lock
+	static void freeUntracked(void* ptr, bool isArray) noexcept {
+#ifdef _MTP_FLIGHT_RECORDER
+		FlightRecorder::record(ptr, 0, {}, FlightRecorder::FLAG_FREE | (isArray ? static_cast<uint32_t>(FlightRecorder::FLAG_ARRAY) : 0u));
+#else
+		(void)isArray;
+#endif // _MTP_FLIGHT_RECORDER
+		AllocatorBackend::deallocate(ptr);
+	};
+
+	// Read the MTP_TRACKING environment variable
+	_NODISCARD static bool getTrackingEnv(bool defaultValue) noexcept {
+		const char* value = std::getenv("MTP_TRACKING");
+		if (value == nullptr) return defaultValue;
+		bool isEnabled = defaultValue;
+		return parseFlagOption(value, std::strlen(value), isEnabled) ? isEnabled : defaultValue;
+	};
+
+	// Parse the MTP_OPTIONS text (without any heap allocation)
+	_NODISCARD static RuntimeOptions parseRuntimeOptions(const char* text) noexcept {
+		using OptionParser = bool (*)(RuntimeOptions& options, const char* value, size_t length);
+		struct OptionEntry {
+			const char*		key;
+			OptionParser	parse;
+		};
+		static const OptionEntry optionTable[] = {
+			{ "tracking",			[](RuntimeOptions& options, const char* value, size_t length) { return parseFlagOption(value, length, options.isTrackingEnabled); } },
+			{ "flight",				[](RuntimeOptions& options, const char* value, size_t length) { return parseFlagOption(value, length, options.isFlightRecorderEnabled); } },
+			{ "signals",			[](RuntimeOptions& options, const char* value, size_t length) { return parseFlagOption(value, length, options.isSignalDump); } },
+			{ "report",				[](RuntimeOptions& options, const char* value, size_t length) { return parseReportOption(value, length, options); } },
+			{ "persist",			[](RuntimeOptions& options, const char* value, size_t length) { return parseTextOption(value, length, options.persistPath); } },
+			{ "persist_callsites",	[](RuntimeOptions& options, const char* value, size_t length) { return parseCountOption(value, length, options.persistCallsites); } },
+			{ "persist_events",		[](RuntimeOptions& options, const char* value, size_t length) { return parseCountOption(value, length, options.persistEvents); } },
+			{ "small",				[](RuntimeOptions& options, const char* value, size_t length) { return parseCountOption(value, length, options.smallBlockThreshold); } },
+			{ "limit",				[](RuntimeOptions& options, const char* value, size_t length) { return parseCountOption(value, length, options.trackerMemoryLimit); } },
+			{ "profile",			[](RuntimeOptions& options, const char* value, size_t length) { return parseTextOption(value, length, options.profilePath); } },
+		};
+
+		RuntimeOptions options;
+		while (text != nullptr && *text != '\0') {
+			const char* end = text;
+			while (*end != '\0' && *end != ',') ++end;
+			const char* separator = text;
+			while (separator < end && *separator != '=') ++separator;
+			const size_t keyLength = static_cast<size_t>(separator - text);
+			const char* value = (separator < end) ? separator + 1 : end;
+
+			bool isParsed = false;
+			for (const auto& entry : optionTable) {
+				if (std::strlen(entry.key) == keyLength && std::strncmp(entry.key, text, keyLength) == 0) {
+					isParsed = entry.parse(options, value, static_cast<size_t>(end - value));
+					break;
+				}
+			}
+			if (!isParsed && keyLength != 0) ++options.unknownCount;
+			text = (*end != '\0') ? end + 1 : end;
+		}
+		return options;
+	};
+
+	// Parse a boolean option value (0/off/false, 1/on/true)
+	static bool parseFlagOption(const char* value, size_t length, bool& flag) noexcept {
+		auto isValue = [value, length](const char* text) { return std::strlen(text) == length && std::strncmp(text, value, length) == 0; };
+		if (isValue("0") || isValue("off") || isValue("false")) flag = false;
+		else if (isValue("1") || isValue("on") || isValue("true")) flag = true;
+		else return false;
+		return true;
+	};
+
+	// Parse a count option value, with an optional k/m/g suffix (e.g. 512k)
+	template<typename _Ty>
+	static bool parseCountOption(const char* value, size_t length, _Ty& count) noexcept {
+		const uint64_t maxCount = static_cast<uint64_t>(static_cast<_Ty>(~static_cast<_Ty>(0)));
+		uint64_t result = 0;
+		size_t idx = 0;
+		for (; idx < length && value[idx] >= '0' && value[idx] <= '9'; ++idx) {
+			result = result * 10 + static_cast<uint64_t>(value[idx] - '0');
+			if (result > maxCount) return false;
+		}
+		if (idx == 0) return false;
+		unsigned shift = 0;
+		if (idx + 1 == length && (value[idx] == 'k' || value[idx] == 'K')) shift = 10;
+		else if (idx + 1 == length && (value[idx] == 'm' || value[idx] == 'M')) shift = 20;
+		else if (idx + 1 == length && (value[idx] == 'g' || value[idx] == 'G')) shift = 30;
+		else if (idx != length) return false;
+		if (result > (maxCount >> shift)) return false;
+		count = static_cast<_Ty>(result << shift);
+		return true;
+	};
+
+	// Copy a text option value into a fixed buffer
+	static bool parseTextOption(const char* value, size_t length, char (&text)[RuntimeOptions::MAX_PATH_LENGTH]) noexcept {
+		if (length == 0 || length >= RuntimeOptions::MAX_PATH_LENGTH) return false;
+		std::memcpy(text, value, length);
+		text[length] = '\0';
+		return true;
+	};
+
+	// Parse the termination report option (format[:path])
+	static bool parseReportOption(const char* value, size_t length, RuntimeOptions& options) noexcept {
+		static const char* const formatNames[] = { "text", "json", "csv", "binary" };
+		size_t nameLength = 0;
+		while (nameLength < length && value[nameLength] != ':') ++nameLength;
+		uint8_t format = 0;
+		for (uint8_t idx = 0; idx < 4; ++idx)
+			if (std::strlen(formatNames[idx]) == nameLength && std::strncmp(formatNames[idx], value, nameLength) == 0)
+				format = idx + 1;
+		if (format == 0) return false;
+		if (nameLength < length && !parseTextOption(value + nameLength + 1, length - nameLength - 1, options.reportPath)) return false;
+		options.reportFormat = format;
+		return true;
+	};
+
+	// Apply the startup options (called once the tracker is initialized)
+	void applyRuntimeOptions(void) {
+#ifdef _MTP_FLIGHT_RECORDER
+		if (!runtimeOptions_.isFlightRecorderEnabled) setFlightRecorderEnabled(false);
+#endif // _MTP_FLIGHT_RECORDER
+		if (runtimeOptions_.isSignalDump) installSignalReportHandlers();
+		if (runtimeOptions_.smallBlockThreshold != 0) setSmallBlockThreshold(runtimeOptions_.smallBlockThreshold);
+		if (runtimeOptions_.trackerMemoryLimit != 0)
+			setTrackerMemoryLimit(static_cast<size_t>((runtimeOptions_.trackerMemoryLimit < SIZE_LIMIT) ? runtimeOptions_.trackerMemoryLimit : SIZE_LIMIT));
+		if (runtimeOptions_.persistPath[0] != '\0')
+			enablePersistentState(runtimeOptions_.persistPath, runtimeOptions_.persistCallsites, runtimeOptions_.persistEvents);
+	};
+
+	// Print the termination report selected by the runtime options
+	void printRuntimeReport(void) const {
+#if _HAS_CXX17
+		// Report format indices follow ReportFormat, offset by one
+		const ReportFormat format = static_cast<ReportFormat>(runtimeOptions_.reportFormat - 1);
+		if (runtimeOptions_.reportPath[0] != '\0')
+			(void)writeTrackingReport(runtimeOptions_.reportPath, format);
+		else
+			printTrackingReport(std::cout, format);
+#else
+		// Only the console text report is available before C++ 17
+		printTrackingReport(std::cout);
+#endif // _HAS_CXX17
+	};
+
+	// Called after a live allocation is recorded (the caller holds the tracker lock)
+	void onTrackInsert(Address ptr, const AllocInfo& allocInfo, const DebugInfo& debugInfo) {
+		if (persistentState_.isOpen()) persistentState_.onAlloc(ptr, allocInfo.size, debugInfo);
+#ifdef _MTP_GROWTH_TRACKING
+		growthTracker_.onAlloc(ptr, allocInfo.size, debugInfo);
+#endif // _MTP_GROWTH_TRACKING
+#ifdef _MTP_FLIGHT_RECORDER
+		FlightRecorder::record(ptr, allocInfo.size, debugInfo,
+			FlightRecorder::FLAG_TRACKED | (allocInfo.isArray ? static_cast<uint32_t>(FlightRecorder::FLAG_ARRAY) : 0u));
+#endif // _MTP_FLIGHT_RECORDER
+	};
+
+	// Called after a live allocation is removed (the caller holds the tracker lock)
+	void onTrackErase(Address ptr, const AllocInfo& allocInfo, const DebugInfo& debugInfo) {
+		if (persistentState_.isOpen()) persistentState_.onFree(ptr, allocInfo.size, debugInfo);
+#ifdef _MTP_GROWTH_TRACKING
+		growthTracker_.onFree(ptr, allocInfo.size, debugInfo);
+#endif // _MTP_GROWTH_TRACKING
+#ifdef _MTP_FLIGHT_RECORDER
+		FlightRecorder::record(ptr, allocInfo.size, debugInfo,
+			FlightRecorder::FLAG_FREE | FlightRecorder::FLAG_TRACKED | (allocInfo.isArray ? static_cast<uint32_t>(FlightRecorder::FLAG_ARRAY) : 0u));
+#endif // _MTP_FLIGHT_RECORDER
+	};
+
+	// Publish a new hook list with one more hook (lists are immutable once published)
+	HookId addHook(std::atomic<HookList*>& hooks, AllocHook hook, void* context) {
+		if (hook == nullptr) return 0;
+#ifdef _MTP_THREADSAFETY
+		MutexLockGuard lock(myMutex_);
+#endif // _MTP_THREADSAFETY
+		const HookList* current = hooks.load(std::memory_order_relaxed);
+		if (current != nullptr && current->count == MAX_HOOKS) return 0;
+		HookList* updated = newHookList(current);
+		if (updated == nullptr) return 0;
+		updated->entries[updated->count++] = { ++lastHookId_, hook, context };
+		publishHookList(hooks, updated);
+		return lastHookId_;
+	};
+
+	// Publish a new hook list without the given hook
+	bool removeHook(std::atomic<HookList*>& hooks, HookId hookId) {
+#ifdef _MTP_THREADSAFETY
+		MutexLockGuard lock(myMutex_);
+#endif // _MTP_THREADSAFETY
+		const HookList* current = hooks.load(std::memory_order_relaxed);
+		if (current == nullptr) return false;
+		HookList* updated = newHookList(nullptr);
+		if (updated == nullptr) return false;
+		for (size_t idx = 0; idx < current->count; ++idx)
+			if (current->entries[idx].id != hookId)
+				updated->entries[updated->count++] = current->entries[idx];
+		if (updated->count == current->count) {
+			freeHookList(updated);
+			return false;
+		}
+		if (updated->count == 0) {
+			freeHookList(updated);
+			updated = nullptr;
+		}
+		publishHookList(hooks, updated);
+		return true;
+	};
+
+	// Allocate a hook list, copying the hooks of another one
+	_NODISCARD static HookList* newHookList(const HookList* source) noexcept {
+		HookList* list = static_cast<HookList*>(std::malloc(sizeof(HookList)));
+		if (list == nullptr) return nullptr;
+		addOverhead(OverheadCategory::Buffers, getHeapBlockCost(sizeof(HookList)));
+		list->count = 0;
+		list->nextRetired = nullptr;
+		if (source != nullptr)
+			for (; list->count < source->count; ++list->count)
+				list->entries[list->count] = source->entries[list->count];
+		return list;
+	};
+
+	// Release a hook list
+	static void freeHookList(HookList* list) noexcept {
+		std::free(list);
+		subOverhead(OverheadCategory::Buffers, getHeapBlockCost(sizeof(HookList)));
+	};
+
+	// Swap in a new hook list, the old one is retired (hooks may still be running from it) until the tracker is destroyed
+	void publishHookList(std::atomic<HookList*>& hooks, HookList* updated) {
+		HookList* retired = hooks.exchange(updated, std::memory_order_acq_rel);
+		if (retired != nullptr) {
+			retired->nextRetired = retiredHooks_;
+			retiredHooks_ = retired;
+		}
+	};
+
+	// Call the hooks of a list (an atomic load and an indirect call per hook)
+	static void invokeHooks(const std::atomic<HookList*>& hooks, void* ptr, size_t size, bool isArray, const DebugInfo& debugInfo) {
+		const HookList* list = hooks.load(std::memory_order_acquire);
+		if (list == nullptr) return;
+
+		// Allocations made by the hooks themselves are not reported again
+		thread_local bool isInHook = false;
+		if (isInHook) return;
+		AllocGuard hookGuard(isInHook);
+		const uint32_t threadIndex = getThreadIndex();
+		for (size_t idx = 0; idx < list->count; ++idx)
+			list->entries[idx].hook(ptr, size, isArray, debugInfo, threadIndex, list->entries[idx].context);
+	};
+
+	// Visit each live allocation, including the changes deferred by a pinned epoch (the caller holds the tracker lock)
+	template<typename _Visitor>
+	void forEachLiveLocked(_Visitor&& visitor) const {
+		if (!isTableCollected_) {
+			for (const auto& info : allocTrackData_)
+				if (epochDelta_.empty() || epochDelta_.find(info.first) == epochDelta_.end())
+					visitor(makeAllocRecord(info));
+		}
+		for (const auto& delta : epochDelta_)
+			if (delta.second.isLive)
+				visitor(AllocRecord{ delta.first, delta.second.allocInfo.size, delta.second.allocInfo.isArray, delta.second.debugInfo });
+	};
+
+	// Apply up to maxCount of the tracking changes deferred while an epoch was pinned (the caller holds the tracker lock, no epoch pinned)
+	// Note: Each change is removed once applied, the rest stays deferred if the table cannot grow
+	void foldEpochDelta(size_t maxCount = SIZE_LIMIT) const {
+		if (epochDelta_.empty()) return;
+		TableMutationGuard mutationGuard(isTableMutating_, isDumpingTable_);
+		auto it = epochDelta_.begin();
+		for (size_t count = 0; it != epochDelta_.end() && count < maxCount; ++count) {
+			applyEpochDelta(*it);
+			it = epochDelta_.erase(it);
+		}
+	};
+
+	// Apply the deferred change of a block about to change, then a bounded batch of the others, so that no single
+	// operation folds the whole delta (the caller holds the tracker lock, no epoch pinned)
+	void foldEpochDeltaStep(Address ptr) const {
+		auto it = epochDelta_.find(ptr);
+		if (it != epochDelta_.end()) {
+			TableMutationGuard mutationGuard(isTableMutating_, isDumpingTable_);
+			applyEpochDelta(*it);
+			epochDelta_.erase(it);
+		}
+		foldEpochDelta(EPOCH_FOLD_BATCH);
+	};
+
+	void applyEpochDelta(const EpochDeltaData::value_type& delta) const {
+		if (delta.second.isLive) {
+			allocTrackData_[delta.first] = delta.second.allocInfo;
+			debugTrackData_.insert(delta.first, delta.second.debugInfo.file, delta.second.debugInfo.line);
+		}
+		else {
+			allocTrackData_.erase(delta.first);
+			debugTrackData_.erase(delta.first);
+		}
+	};
+
+	// Empty the tracking table once the garbage collection released its blocks (the caller holds the tracker lock, no epoch pinned)
+	void clearCollectedTable(void) const {
+		TableMutationGuard mutationGuard(isTableMutating_, isDumpingTable_);
+		allocTrackData_.clear();
+		debugTrackData_.clear();
+		isTableCollected_ = false;
+	};
+
+	// Number of epochs pinned by the calling thread
+	_NODISCARD static size_t& getPinDepth(void) noexcept {
+		thread_local size_t pinDepth = 0;
+		return pinDepth;
+	};
+
+	// Pin the current epoch for a reader, return the pinned epoch
+	// Note: While the deferred changes exceed MAX_EPOCH_DELTA, a new reader waits for the pinned ones to leave (unless
+	//		 its thread already pins an epoch), so that overlapping readers cannot defer them forever.
+	//		 The first reader folds the remaining changes, the pinned table holds all of them.
+	uint64_t enterEpoch(void) const {
+#ifdef _MTP_THREADSAFETY
+		MutexUniqueLock lock(myMutex_);
+		if (getPinDepth() == 0) {
+			while (epochReaders_ != 0 && epochDelta_.size() >= MAX_EPOCH_DELTA) {
+				lock.unlock();
+				std::this_thread::yield();
+				lock.lock();
+			}
+		}
+#endif // _MTP_THREADSAFETY
+		if (epochReaders_ == 0) {
+			if (isTableCollected_) clearCollectedTable();
+			foldEpochDelta();
+			++epoch_;
+		}
+		++epochReaders_;
+		++getPinDepth();
+		return epoch_;
+	};
+
+	// Unpin the epoch of a reader, the writers then fold the deferred changes back in small batches
+	void leaveEpoch(void) const {
+#ifdef _MTP_THREADSAFETY
+		MutexLockGuard lock(myMutex_);
+#endif // _MTP_THREADSAFETY
+		--getPinDepth();
+		if (--epochReaders_ != 0) return;
+		try {
+			if (isTableCollected_) clearCollectedTable();
+			foldEpochDelta(EPOCH_FOLD_BATCH);
+		}
+		catch (...) {}					// Folded by the next operations
+	};
+
+	// Build a live allocation record from a tracking table entry
+	_NODISCARD AllocRecord makeAllocRecord(const AllocTrackData::value_type& info) const noexcept {
+		AllocRecord record;
+		record.address = info.first;
+		record.size = info.second.size;
+		record.isArray = info.second.isArray;
+		const DebugInfo* debugInfo = debugTrackData_.get(info.first);
+		if (debugInfo != nullptr) record.callsite = *debugInfo;
+		return record;
+	};
+
+	// Print memory tracking info
+	void printTrackingInfo(const AllocRecord& record, std::ostream& os, bool newLine) const noexcept {
+		os << "Leaked: " << record.size << " bytes "
+			<< (record.isArray ? "of an array " : "") << "at " << record.address;
+#ifdef _MTP_DEBUG
+		if (record.callsite.file != nullptr || record.callsite.line != -1) {
+			os << " in " << ((record.callsite.file != nullptr) ? record.callsite.file : "unknown file");
+			if (record.callsite.line != -1)
+				os << " (line:" << record.callsite.line << ")";
+			else
+				os << " (line: unknown)";
+		}
+#endif // _MTP_DEBUG
+		os << (newLine ? ".\n" : ".");
+	};
+
+public:
+	// Get size of the allocation tracker (in bytes)
+	_NODISCARD size_t getTrackerSize(void) const {
+		return getTrackerOverhead().totalBytes;
+	};
+
+	// Get the breakdown of the tracker's own memory (heap blocks include an estimate of the allocator headers),
+	// and an estimate of the CPU time spent tracking
+	// Note: The tables belong to this tracker, the buffers and the storage of the static components
+	//		 (report temporaries, hook lists, flight recorder rings, ...) are shared by all tracker instances
+	_NODISCARD TrackerOverhead getTrackerOverhead(void) const {
+		TrackerOverhead overhead;
+		const std::atomic<size_t>* counters = overheadCounters();
+		auto categoryBytes = [&](OverheadCategory category) {
+			return overheadBytes_[static_cast<size_t>(category)].load(std::memory_order_relaxed)
+				+ counters[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+		};
+		overhead.tableBytes = categoryBytes(OverheadCategory::Table);
+		overhead.debugInfoBytes = categoryBytes(OverheadCategory::DebugInfo);
+		overhead.callsiteBytes = categoryBytes(OverheadCategory::Callsites);
+		overhead.bufferBytes = categoryBytes(OverheadCategory::Buffers);
+		{
+#ifdef _MTP_THREADSAFETY
+			MutexLockGuard lock(myMutex_);
+#endif // _MTP_THREADSAFETY
+			overhead.callsiteBytes += getSmallBlockHeaderMemory() + persistentState_.getMappedSize();
+		}
+#ifdef _MTP_FLIGHT_RECORDER
+		for (auto* ring = FlightRecorder::rings().load(std::memory_order_acquire); ring != nullptr; ring = ring->next)
+			overhead.bufferBytes += getHeapBlockCost(sizeof(*ring));
+#endif // _MTP_FLIGHT_RECORDER
+		overhead.fixedBytes = sizeof(*this);
+		overhead.totalBytes = overhead.tableBytes + overhead.debugInfoBytes + overhead.callsiteBytes + overhead.bufferBytes + overhead.fixedBytes;
+
+		overhead.sampledOperations = sampledOperations_.load(std::memory_order_relaxed);
+		const uint64_t sampledNanoseconds = sampledNanoseconds_.load(std::memory_order_relaxed);
+		if (overhead.sampledOperations != 0) overhead.averageNanoseconds = sampledNanoseconds / overhead.sampledOperations;
+		overhead.cpuNanoseconds = sampledNanoseconds * OVERHEAD_SAMPLE_RATE;
+		return overhead;
+	};
+
+	// Print the breakdown of the tracker's own memory and CPU overhead (to file/console, ...)
+	void printTrackerOverhead(std::ostream& os) const {
+		const TrackerOverhead overhead = getTrackerOverhead();
+		os << "\n--- Memory Tracker Overhead ---\n"
+			<< "Table: " << overhead.tableBytes << " bytes.\n"
+			<< "Debug info: " << overhead.debugInfoBytes << " bytes.\n"
+			<< "Callsites: " << overhead.callsiteBytes << " bytes.\n"
+			<< "Buffers: " << overhead.bufferBytes << " bytes.\n"
+			<< "Tracker object: " << overhead.fixedBytes << " bytes.\n"
+			<< "Total: " << overhead.totalBytes << " bytes.\n"
+			<< "CPU: about " << overhead.averageNanoseconds << " ns per tracked operation, "
+			<< (overhead.cpuNanoseconds / 1000000) << " ms in total (estimated from " << overhead.sampledOperations << " samples).\n";
+	};
+
+	// Get total tracked allocated memory sizes (in bytes), small blocks, small objects and pool objects included
+	_NODISCARD size_t getMemorySize(void) const {
+		size_t poolCount = 0, bytes = 0;
+		countPoolObjects(poolCount, bytes);
+#ifdef _MTP_THREADSAFETY
+		MutexLockGuard lock(myMutex_);
+#endif // _MTP_THREADSAFETY
+		bytes += liveBytes_ + smallBlocks_.getLiveBytes();
+#ifdef _MTP_SMALL_OBJECT_ALLOCATOR
+		bytes += SmallObjectAllocator::getStats().liveBytes;
+#endif // _MTP_SMALL_OBJECT_ALLOCATOR
+		return bytes;
+	};
+
+	// Get the number of tracking allocated memory blocks, small blocks, small objects and pool objects included
+	_NODISCARD size_t getPtrCount(void) const {
+		size_t count = 0, poolBytes = 0;
+		countPoolObjects(count, poolBytes);
+#ifdef _MTP_THREADSAFETY
+		MutexLockGuard lock(myMutex_);
+#endif // _MTP_THREADSAFETY
+		count += liveCount_ + smallBlocks_.getLiveCount();
+#ifdef _MTP_SMALL_OBJECT_ALLOCATOR
+		count += SmallObjectAllocator::getStats().liveCount;
+#endif // _MTP_SMALL_OBJECT_ALLOCATOR
+		return count;
+	};
+
+	// Check if there are any allocated memory blocks in use or not yet freed
+	_NODISCARD bool isMemoryLeak(void) const {
+		size_t poolCount = 0, poolBytes = 0;
+		countPoolObjects(poolCount, poolBytes);
+		if (poolCount != 0) return true;
+#ifdef _MTP_THREADSAFETY
+		MutexLockGuard lock(myMutex_);
+#endif // _MTP_THREADSAFETY
+#ifdef _MTP_SMALL_OBJECT_ALLOCATOR
+		if (SmallObjectAllocator::getStats().liveCount != 0) return true;
+#endif // _MTP_SMALL_OBJECT_ALLOCATOR
+		return (liveCount_ != 0) || (smallBlocks_.getLiveCount() != 0);
+	};
+
+	// Set the size under which new blocks are only counted per callsite/size class instead of being
+	// tracked individually (0 tracks every block individually, the default)
+	// Note: Small blocks carry a header and are not freed by the garbage collection at termination
+	void setSmallBlockThreshold(size_t threshold) noexcept {
+		smallBlockThreshold_.store(threshold, std::memory_order_relaxed);
+	};
+
+	// Get the size under which new blocks are only counted per callsite/size class
+	_NODISCARD size_t getSmallBlockThreshold(void) const noexcept {
+		return smallBlockThreshold_.load(std::memory_order_relaxed);
+	};
+
+	// Cap the per-address memory of the tracker (0: unlimited), once it is reached new blocks come from the overflow
+	// slabs and are only counted per callsite/size class, until enough tracked blocks are freed
+	// Note: The capped memory is the tracking table, the debug tracking info, the small block set and the small block
+	//		 headers. The overflow slabs need no per-address entry, only a directory entry per slab.
+	void setTrackerMemoryLimit(size_t limit) noexcept {
+#ifdef _MTP_THREADSAFETY
+		MutexLockGuard lock(myMutex_);
+#endif // _MTP_THREADSAFETY
+		trackerMemoryLimit_ = limit;
+		updateTableFull();
+	};
+
+	// Get the memory cap of the tracking table (0: unlimited)
+	_NODISCARD size_t getTrackerMemoryLimit(void) const {
+#ifdef _MTP_THREADSAFETY
+		MutexLockGuard lock(myMutex_);
+#endif // _MTP_THREADSAFETY
+		return trackerMemoryLimit_;
+	};
+
+	// Get how many blocks were summarized because the tracking table reached its memory limit
+	_NODISCARD OverflowSummary getOverflowSummary(void) const {
+#ifdef _MTP_THREADSAFETY
+		MutexLockGuard lock(myMutex_);
+#endif // _MTP_THREADSAFETY
+		return overflowSummary_;
+	};
+
+	// Get the allocation profile of the previous run loaded at startup (version 0 if none was loaded)
+	_NODISCARD const StartupProfile& getStartupProfile(void) const noexcept {
+		return startupProfile_;
+	};
+
+	// Write the allocation profile of this run (peak counts, most frequent size classes), return true on success
+	// Note: The profile is written on exit when MTP_OPTIONS sets profile=path, and read back at the next startup
+	bool writeStartupProfile(const char* path) const {
+		StartupProfile profile;
+		{
+#ifdef _MTP_THREADSAFETY
+			MutexLockGuard lock(myMutex_);
+#endif // _MTP_THREADSAFETY
+			std::memcpy(profile.magic, "MTPPROF", 8);
+			profile.version = StartupProfile::VERSION;
+			profile.peakLiveCount = peakLiveCount_;
+			profile.peakSmallCount = peakSmallCount_;
+			for (size_t idx = 0; idx < SIZE_CLASS_COUNT; ++idx) {
+				const uint64_t count = sizeClassCounts_[idx];
+				profile.totalAllocs += count;
+				if (count == 0) continue;
+
+				// Insert in the most frequent classes, in decreasing count order
+				uint32_t pos = profile.sizeClassCount;
+				while (pos > 0 && profile.sizeClasses[pos - 1].count < count) {
+					if (pos < StartupProfile::MAX_SIZE_CLASSES) profile.sizeClasses[pos] = profile.sizeClasses[pos - 1];
+					--pos;
+				}
+				if (pos < StartupProfile::MAX_SIZE_CLASSES) {
+					profile.sizeClasses[pos] = { static_cast<uint64_t>(1) << idx, count };
+					if (profile.sizeClassCount < StartupProfile::MAX_SIZE_CLASSES) ++profile.sizeClassCount;
+				}
+			}
+		}
+		if (path == nullptr) return false;
+#ifdef _WIN32
+		int fd = _open(path, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+		if (fd < 0) return false;
+		const bool isWritten = _write(fd, &profile, sizeof(profile)) == static_cast<int>(sizeof(profile));
+		_close(fd);
+#else
+		int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+		if (fd < 0) return false;
+		const bool isWritten = ::write(fd, &profile, sizeof(profile)) == static_cast<ssize_t>(sizeof(profile));
+		::close(fd);
+#endif // _WIN32
+		return isWritten;
+	};
+
+	// Read an allocation profile written by writeStartupProfile(), return false if missing or invalid
+	static bool readStartupProfile(const char* path, StartupProfile& profile) noexcept {
+		if (path == nullptr) return false;
+		StartupProfile loaded;
+#ifdef _WIN32
+		int fd = _open(path, _O_RDONLY | _O_BINARY);
+		if (fd < 0) return false;
+		const bool isRead = _read(fd, &loaded, sizeof(loaded)) == static_cast<int>(sizeof(loaded));
+		_close(fd);
+#else
+		int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+		if (fd < 0) return false;
+		const bool isRead = ::read(fd, &loaded, sizeof(loaded)) == static_cast<ssize_t>(sizeof(loaded));
+		::close(fd);
+#endif // _WIN32
+		if (!isRead || std::memcmp(loaded.magic, "MTPPROF", 8) != 0 || loaded.version != StartupProfile::VERSION
+			|| loaded.sizeClassCount > StartupProfile::MAX_SIZE_CLASSES) return false;
+		profile = loaded;
+		return true;
+	};
+
+	// Get the live small block groups, ordered by bytes (blockSize is the size class, a multiple of 8 bytes)
+	_NODISCARD TopLeaks getSmallBlockLeaks(void) const {
+		TopLeaks smallLeaks;
+		{
+#ifdef _MTP_THREADSAFETY
+			MutexLockGuard lock(myMutex_);
+#endif // _MTP_THREADSAFETY
+			smallBlocks_.forEach([&smallLeaks](const LeakGroup& group) { smallLeaks.push_back(group); });
+		}
+		std::sort(smallLeaks.begin(), smallLeaks.end(), [](const LeakGroup& lhs, const LeakGroup& rhs) { return lhs.bytes > rhs.bytes; });
+		return smallLeaks;
+	};
+
+	// Get the live blocks reported beside the tracking table records (small block groups, small objects, pool objects)
+	_NODISCARD ReportExtras getReportExtras(void) const {
+		ReportExtras extras;
+		extras.smallBlocks = getSmallBlockLeaks();
+#ifdef _MTP_SMALL_OBJECT_ALLOCATOR
+		size_t classCounts[SmallObjectAllocator::CLASS_COUNT] = {};
+		SmallObjectAllocator::forEachLive([&](void*, size_t slotSize) {
+			++classCounts[slotSize / SmallObjectAllocator::SIZE_STEP - 1];
+		});
+		for (size_t classIndex = 0; classIndex < SmallObjectAllocator::CLASS_COUNT; ++classIndex) {
+			if (classCounts[classIndex] == 0) continue;
+			LeakGroup group;
+			group.blockSize = (classIndex + 1) * SmallObjectAllocator::SIZE_STEP;
+			group.count = classCounts[classIndex];
+			group.bytes = group.count * group.blockSize;
+			extras.smallObjects.push_back(group);
+		}
+#endif // _MTP_SMALL_OBJECT_ALLOCATOR
+		for (PoolRegistration* pool = pools().load(std::memory_order_acquire); pool != nullptr; pool = pool->next) {
+			std::pair<PoolObjects*, const char*> output(&extras.poolObjects, pool->name);
+			pool->forEachLive([](const void* object, size_t size, void* context) {
+				auto* output = static_cast<std::pair<PoolObjects*, const char*>*>(context);
+				output->first->push_back({ object, size, output->second });
+			}, &output);
+		}
+		extras.overflow = getOverflowSummary();
+		return extras;
+	};
+
+	// Record a block allocated outside of the tracker (e.g. by a memory resource), the tag is reported as its file
+	// Note: A block already tracked (allocated by the overridden operator new) is tagged again in place, without
+	//		 any new allocation event (its allocation was already reported)
+	void trackExternalAlloc(void* ptr, size_t size, const char* tag) {
+		// Not recorded while tracking is disabled, as the blocks of smartAlloc() (trackExternalFree() ignores them)
+		if (ptr == nullptr || !isTrackingEnabled_.load(std::memory_order_relaxed)) return;
+		{
+			AllocGuard allocGuard(getReentryFlag());
+			OverheadSampler sampler(*this);
+#ifdef _MTP_THREADSAFETY
+			MutexLockGuard lock(myMutex_);
+#endif // _MTP_THREADSAFETY
+			if (!isTrackerInitialized_.load(std::memory_order_acquire)) return;
+			if (liveCount_ != 0 && mayBeTracked(ptr) && trackRetag(ptr, { tag, -1 })) return;
+			trackInsert(ptr, { size, false }, { tag, -1 });
+		}
+
+		// Notify the subscribers (outside of the tracker lock)
+		invokeHooks(allocHooks_, ptr, size, false, { tag, -1 });
+	};
+
+	// Forget a block recorded by trackExternalAlloc() before it is freed, return its recorded size (0 if not tracked)
+	size_t trackExternalFree(void* ptr) {
+		if (ptr == nullptr || !mayBeTracked(ptr)) return 0;
+		AllocRecord erased;
+		EraseResult result = EraseResult::Unknown;
+		{
+			OverheadSampler sampler(*this);
+#ifdef _MTP_THREADSAFETY
+			MutexLockGuard lock(myMutex_);
+#endif // _MTP_THREADSAFETY
+			if (liveCount_ != 0) result = trackErase(ptr, false, &erased);
+		}
+		if (result != EraseResult::Erased) return 0;
+
+		// Notify the subscribers (outside of the tracker lock)
+		invokeHooks(freeHooks_, ptr, erased.size, false, erased.callsite);
+		return erased.size;
+	};
+
+	// Register a typed object pool, so that its live objects are listed by the leak reports (shared by all trackers)
+	// Note: Registrations are never removed, the pool must live until the program ends
+	static void registerPool(PoolRegistration& pool) noexcept {
+		PoolRegistration* head = pools().load(std::memory_order_relaxed);
+		do {
+			pool.next = head;
+		} while (!pools().compare_exchange_weak(head, &pool, std::memory_order_release, std::memory_order_relaxed));
+	};
+
+#ifdef _MTP_SMALL_OBJECT_ALLOCATOR
+	// Get the slab and live counts of the small object allocator (scans the slab bitmaps, shared by all trackers)
+	_NODISCARD static SmallObjectStats getSmallObjectStats(void) noexcept {
+		return SmallObjectAllocator::getStats();
+	};
+
+	// Visit each live small object: visitor(void* address, size_t slotSize)
+	template<typename _Visitor>
+	static void forEachSmallObject(_Visitor&& visitor) {
+		SmallObjectAllocator::forEachLive(visitor);
+	};
+#endif // _MTP_SMALL_OBJECT_ALLOCATOR
+
+	// Enable/disable tracking at runtime (new allocations are not tracked while disabled)
+	void setTrackingEnabled(bool isEnabled) noexcept {
+		isTrackingEnabled_.store(isEnabled, std::memory_order_relaxed);
+	};
+
+	// Check if new allocations are being tracked
+	_NODISCARD bool isTrackingEnabled(void) const noexcept {
+		return isTrackingEnabled_.load(std::memory_order_relaxed);
+	};
+
+	// Select the backing allocator at startup, with _MTP_ALLOCATOR_BACKEND defined as MemTrackifyPlus::DynamicBackend
+	// Note: Only works before the first allocation (returns false afterwards, or with any other backend)
+	static bool setAllocatorBackend(const AllocatorFunctions& functions) noexcept {
+		if (!std::is_same<AllocatorBackend, DynamicBackend>::value) return false;
+		return DynamicBackend::select(functions);
+	};
+
+	// Get the runtime options parsed from MTP_OPTIONS at startup
+	_NODISCARD const RuntimeOptions& getRuntimeOptions(void) const noexcept {
+		return runtimeOptions_;
+	};
+
+	// Get the current tracking epoch (advances each time a reader pins a new one)
+	_NODISCARD uint64_t getEpoch(void) const {
+#ifdef _MTP_THREADSAFETY
+		MutexLockGuard lock(myMutex_);
+#endif // _MTP_THREADSAFETY
+		return epoch_;
+	};
+
+	// Pins a tracking epoch: the tracking table stays frozen and can be read without the tracker lock,
+	// while allocating threads record their changes aside, folded back in small batches once the last pin is released
+	class EpochPin {
+	public:
+		// Construction
+		explicit EpochPin(const MemTrackifyPlus& tracker) : tracker_(&tracker), epoch_(tracker.enterEpoch()) {};
+		EpochPin(EpochPin&& other) noexcept : tracker_(other.tracker_), epoch_(other.epoch_) { other.tracker_ = nullptr; };
+		~EpochPin() { if (tracker_) tracker_->leaveEpoch(); };
+
+		// Attributes
+		_NODISCARD uint64_t epoch(void) const noexcept { return epoch_; };
+
+	private:
+		// No copyable
+		EpochPin(const EpochPin&) = delete;
+		EpochPin& operator=(const EpochPin&) = delete;
+
+	private:
+		const MemTrackifyPlus*	tracker_;
+		uint64_t				epoch_;
+	};
+
+	// Pin the current tracking epoch to get a consistent view of the live allocations
+	_NODISCARD EpochPin pinEpoch(void) const {
+		return EpochPin(*this);
+	};
+
+	// Forward iterator over live allocation records (yields records by value, no allocation)
+	class LiveIterator {
+	public:
+		using iterator_category	= typename std::forward_iterator_tag;
+		using value_type		= AllocRecord;
+		using difference_type	= typename std::ptrdiff_t;
+		using pointer			= const AllocRecord*;
+		using reference			= AllocRecord;
+
+		// Construction
+		LiveIterator(const MemTrackifyPlus* tracker, AllocTrackData::const_iterator it) noexcept
+			: tracker_(tracker), it_(it) {};
+
+		// Operations
+		_NODISCARD AllocRecord operator*() const noexcept { return tracker_->makeAllocRecord(*it_); };
+		LiveIterator& operator++() noexcept { ++it_; return *this; };
+		LiveIterator operator++(int) noexcept { LiveIterator tmp(*this); ++it_; return tmp; };
+		_NODISCARD bool operator==(const LiveIterator& other) const noexcept { return it_ == other.it_; };
+		_NODISCARD bool operator!=(const LiveIterator& other) const noexcept { return it_ != other.it_; };
+
+	private:
+		const MemTrackifyPlus*			tracker_;
+		AllocTrackData::const_iterator	it_;
+	};
+
+	// Range of live allocation records (pins a tracking epoch for its whole lifetime)
+	class LiveRange {
+	public:
+		// Construction
+		explicit LiveRange(const MemTrackifyPlus& tracker) : tracker_(tracker), pin_(tracker) {};
+
+		// Operations
+		_NODISCARD LiveIterator begin(void) const noexcept { return LiveIterator(&tracker_, tracker_.allocTrackData_.cbegin()); };
+		_NODISCARD LiveIterator end(void) const noexcept { return LiveIterator(&tracker_, tracker_.allocTrackData_.cend()); };
+		_NODISCARD uint64_t epoch(void) const noexcept { return pin_.epoch(); };
+
+	private:
+		const MemTrackifyPlus&	tracker_;
+		EpochPin				pin_;
+	};
+
+	// Iterate over live allocation records in place, as of the epoch pinned by the range
+	_NODISCARD LiveRange liveAllocations(void) const {
+		return LiveRange(*this);
+	};
+
+	// Visit each live allocation record in place, as of a pinned epoch (allocating threads are not blocked)
+	template<typename _Visitor>
+	void forEachLive(_Visitor&& visitor) const {
+		const EpochPin pin(*this);
+		for (const auto& info : allocTrackData_)
+			visitor(makeAllocRecord(info));
+	};
+
+	// Take a consistent snapshot of all live allocation records
+	_NODISCARD AllocSnapshot takeSnapshot(void) const {
+		AllocSnapshot snapshot;
+		const EpochPin pin(*this);
+		snapshot.reserve(allocTrackData_.size());
+		for (const auto& info : allocTrackData_)
+			snapshot.push_back(makeAllocRecord(info));
+		return snapshot;
+	};
+
+	// Visit each live allocation record of a snapshot (other threads may keep allocating meanwhile)
+	template<typename _Visitor>
+	void forEachLiveSnapshot(_Visitor&& visitor) const {
+		const AllocSnapshot snapshot = takeSnapshot();
+		for (const auto& record : snapshot)
+			visitor(record);
+	};
+
+	// Get memory tracking report data (as an array of string)
+	_NODISCARD TrackingReport getTrackingReport(void) const noexcept {
+		if (isInReporting_.exchange(true)) { return {}; }
+		TrackingReport report;
+		const AllocSnapshot snapshot = takeSnapshot();
+		report.reserve(snapshot.size());
+		for (const auto& record : snapshot) {
+			StringStreamData oss;
+			printTrackingInfo(record, oss, false);
+			report.push_back(oss.str());
+		}
+		isInReporting_ = false;
+		return report;
+	};
+
+	// Print memory tracking report data (to file/console, ...)
+	void printTrackingReport(std::ostream& os) const noexcept {
+		const AllocSnapshot snapshot = takeSnapshot();
+		const TopLeaks smallLeaks = getSmallBlockLeaks();
+		bool hasSmallObjects = false;
+#ifdef _MTP_SMALL_OBJECT_ALLOCATOR
+		size_t classCounts[SmallObjectAllocator::CLASS_COUNT] = {};
+		SmallObjectAllocator::forEachLive([&](void*, size_t slotSize) {
+			++classCounts[slotSize / SmallObjectAllocator::SIZE_STEP - 1];
+			hasSmallObjects = true;
+		});
+#endif // _MTP_SMALL_OBJECT_ALLOCATOR
+		bool hasPoolObjects = false;
+		for (PoolRegistration* pool = pools().load(std::memory_order_acquire); pool != nullptr && !hasPoolObjects; pool = pool->next)
+			pool->forEachLive([](const void*, size_t, void* context) { *static_cast<bool*>(context) = true; }, &hasPoolObjects);
+		if (!snapshot.empty() || !smallLeaks.empty() || hasSmallObjects || hasPoolObjects) {
+			os << "\n--- Memory Leaks Detected ---\n";
+			for (const auto& record : snapshot) {
+				printTrackingInfo(record, os, true);
+			}
+			for (const auto& group : smallLeaks) {
+				os << "Leaked: " << group.bytes << " bytes in " << group.count << " aggregated blocks of up to " << group.blockSize << " bytes";
+#ifdef _MTP_DEBUG
+				os << " in " << ((group.callsite.file != nullptr) ? group.callsite.file : "unknown file");
+				if (group.callsite.line != -1)
+					os << " (line:" << group.callsite.line << ")";
+				else
+					os << " (line: unknown)";
+#endif // _MTP_DEBUG
+				os << ".\n";
+			}
+#ifdef _MTP_SMALL_OBJECT_ALLOCATOR
+			for (size_t classIndex = 0; classIndex < SmallObjectAllocator::CLASS_COUNT; ++classIndex) {
+				if (classCounts[classIndex] == 0) continue;
+				const size_t slotSize = (classIndex + 1) * SmallObjectAllocator::SIZE_STEP;
+				os << "Leaked: " << classCounts[classIndex] * slotSize << " bytes in " << classCounts[classIndex]
+					<< " small objects of up to " << slotSize << " bytes.\n";
+			}
+#endif // _MTP_SMALL_OBJECT_ALLOCATOR
+			for (PoolRegistration* pool = pools().load(std::memory_order_acquire); pool != nullptr; pool = pool->next) {
+				std::pair<std::ostream*, const char*> output(&os, pool->name);
+				pool->forEachLive([](const void* object, size_t size, void* context) {
+					auto* output = static_cast<std::pair<std::ostream*, const char*>*>(context);
+					*output->first << "Leaked: " << size << " bytes at " << object << " (" << output->second << " pool object).\n";
+				}, &output);
+			}
+			const OverflowSummary overflow = getOverflowSummary();
+			if (overflow.totalCount != 0) {
+				os << "Tracker memory limit reached: " << overflow.liveCount << " live blocks (" << overflow.liveBytes
+					<< " bytes) are summarized, " << overflow.totalCount << " blocks (" << overflow.totalBytes << " bytes) in total.\n";
+			}
+		}
+		else {
+			os << "\nNo memory leaks detected.\n";
+		}
+	};
+
+	// Get the K largest groups of live allocations, in a single pass over a pinned epoch
+	// Note: Costs O(n + g log k) time and O(g) memory, for n live blocks in g groups
+	_NODISCARD TopLeaks getTopLeaks(size_t k, LeakGroupBy groupBy = LeakGroupBy::Callsite, LeakRankBy rankBy = LeakRankBy::Bytes) const {
+		TopLeaks topLeaks;
+		if (k == 0) return topLeaks;
+
+		// Aggregate the live blocks per group
+		LeakGroupData groups;
+		forEachLive([&](const AllocRecord& record) {
+			LeakGroupKey key;
+			if (groupBy == LeakGroupBy::Size)
+				key.blockSize = record.size;
+			else {
+				key.file = record.callsite.file;
+				key.line = (groupBy == LeakGroupBy::Callsite) ? record.callsite.line : -1;
+			}
+			LeakGroup& group = groups[key];
+			++group.count;
+			group.bytes += record.size;
+		});
+		{
+			// Merge in the small block groups
+#ifdef _MTP_THREADSAFETY
+			MutexLockGuard lock(myMutex_);
+#endif // _MTP_THREADSAFETY
+			smallBlocks_.forEach([&](const LeakGroup& smallGroup) {
+				LeakGroupKey key;
+				if (groupBy == LeakGroupBy::Size)
+					key.blockSize = smallGroup.blockSize;
+				else {
+					key.file = smallGroup.callsite.file;
+					key.line = (groupBy == LeakGroupBy::Callsite) ? smallGroup.callsite.line : -1;
+				}
+				LeakGroup& group = groups[key];
+				group.count += smallGroup.count;
+				group.bytes += smallGroup.bytes;
+			});
+		}
+
+		// Keep the K largest groups in a bounded min-heap
+		auto isLarger = [rankBy](const LeakGroup& lhs, const LeakGroup& rhs) {
+			if (rankBy == LeakRankBy::Count)
+				return (lhs.count != rhs.count) ? (lhs.count > rhs.count) : (lhs.bytes > rhs.bytes);
+			return (lhs.bytes != rhs.bytes) ? (lhs.bytes > rhs.bytes) : (lhs.count > rhs.count);
+		};
+		topLeaks.reserve((k < groups.size()) ? k : groups.size());
+		for (const auto& group : groups) {
+			LeakGroup leakGroup = group.second;
+			leakGroup.callsite = { group.first.file, group.first.line };
+			leakGroup.blockSize = group.first.blockSize;
+			if (topLeaks.size() < k) {
+				topLeaks.push_back(leakGroup);
+				std::push_heap(topLeaks.begin(), topLeaks.end(), isLarger);
+			}
+			else if (isLarger(leakGroup, topLeaks.front())) {
+				std::pop_heap(topLeaks.begin(), topLeaks.end(), isLarger);
+				topLeaks.back() = leakGroup;
+				std::push_heap(topLeaks.begin(), topLeaks.end(), isLarger);
+			}
+		}
+		std::sort_heap(topLeaks.begin(), topLeaks.end(), isLarger);
+		return topLeaks;
+	};
+
+	// Print the K largest groups of live allocations (to file/console, ...)
+	void printTopLeaks(std::ostream& os, size_t k, LeakGroupBy groupBy = LeakGroupBy::Callsite, LeakRankBy rankBy = LeakRankBy::Bytes) const {
+		const TopLeaks topLeaks = getTopLeaks(k, groupBy, rankBy);
+		if (topLeaks.empty()) {
+			os << "\nNo memory leaks detected.\n";
+			return;
+		}
+		os << "\n--- Top " << topLeaks.size() << " Memory Leaks by "
+			<< ((rankBy == LeakRankBy::Count) ? "count" : "bytes") << " (grouped by "
+			<< ((groupBy == LeakGroupBy::Size) ? "size" : (groupBy == LeakGroupBy::File) ? "file" : "callsite") << ") ---\n";
+		size_t rank = 0;
+		for (const auto& group : topLeaks) {
+			os << "  #" << ++rank << ": " << group.bytes << " bytes in " << group.count << " blocks";
+			if (groupBy == LeakGroupBy::Size)
+				os << " of " << group.blockSize << " bytes";
+			else {
+				os << " in " << ((group.callsite.file != nullptr) ? group.callsite.file : "unknown file");
+				if (groupBy == LeakGroupBy::Callsite) {
+					if (group.callsite.line != -1)
+						os << " (line:" << group.callsite.line << ")";
+					else
+						os << " (line: unknown)";
+				}
+			}
+			os << ".\n";
+		}
+	};
+
+	// Get the callsites whose buffers grow through reallocation chains, from the most bytes copied
+	// Note: Only the blocks of the tracking table are followed (not the small blocks counted per callsite),
+	//		 and only with _MTP_GROWTH_TRACKING (no callsites otherwise)
+	_NODISCARD GrowthSites getGrowthSites(size_t minReallocations = 1) const {
+		GrowthSites growthSites;
+#ifndef _MTP_GROWTH_TRACKING
+		(void)minReallocations;
+#else
+#ifdef _MTP_THREADSAFETY
+		MutexLockGuard lock(myMutex_);
+#endif // _MTP_THREADSAFETY
+		growthTracker_.forEach([&](const GrowthSite& growthSite) {
+			if (growthSite.reallocations >= minReallocations) growthSites.push_back(growthSite);
+		});
+		std::sort(growthSites.begin(), growthSites.end(), [](const GrowthSite& lhs, const GrowthSite& rhs) {
+			return (lhs.bytesCopied != rhs.bytesCopied) ? (lhs.bytesCopied > rhs.bytesCopied) : (lhs.reallocations > rhs.reallocations);
+		});
+#endif // !_MTP_GROWTH_TRACKING
+		return growthSites;
+	};
+
+	// Print the callsites with reallocation chains and their suggested initial capacities (to file/console, ...)
+	void printGrowthReport(std::ostream& os, size_t minReallocations = 1) const {
+#ifndef _MTP_GROWTH_TRACKING
+		(void)minReallocations;
+		os << "\nReallocation chains are not tracked (define _MTP_GROWTH_TRACKING).\n";
+#else
+		const GrowthSites growthSites = getGrowthSites(minReallocations);
+		if (growthSites.empty()) {
+			os << "\nNo reallocation chains detected.\n";
+			return;
+		}
+		os << "\n--- Reallocation Chains ---\n";
+		for (const auto& site : growthSites) {
+			os << "  " << site.bytesCopied << " bytes copied in " << site.reallocations << " reallocations of "
+				<< site.chainCount << " chains (longest: " << site.longestChain << ")";
+			os << " in " << ((site.callsite.file != nullptr) ? site.callsite.file : "unknown file");
+			if (site.callsite.line != -1)
+				os << " (line:" << site.callsite.line << ")";
+			else
+				os << " (line: unknown)";
+			os << ", reserve " << site.suggestedCapacity << " bytes up front (largest: " << site.largestFinalBytes << ").\n";
+		}
+#endif // !_MTP_GROWTH_TRACKING
+	};
+
+	// Dump the memory tracking report into a file descriptor, async-signal-safe (usable in signal handlers)
+	// Note: Formats into a static buffer without allocating or locking. Records are skipped (counters are still
+	//		 written) when the tracking table is being modified, by any thread (including the interrupted one).
+	void dumpTrackingReportSignalSafe(int fd, int signalNumber = 0) const noexcept {
+		static AtomicFlag isDumping(false);
+		static char dumpBuffer[16 * 1024];
+		if (isDumping.exchange(true)) return;
+
+		SignalSafeWriter writer(fd, dumpBuffer, sizeof(dumpBuffer));
+		writer.append("\n--- Memory Tracking Dump");
+		if (signalNumber != 0) {
+			writer.append(" (signal ");
+			writer.appendDecimal(static_cast<uint64_t>(signalNumber));
+			writer.append(")");
+		}
+		writer.append(" ---\nLive blocks: ");
+		writer.appendDecimal(liveCount_);
+		writer.append(", live bytes: ");
+		writer.appendDecimal(liveBytes_);
+		if (smallBlocks_.getLiveCount() != 0) {
+			writer.append(", small blocks: ");
+			writer.appendDecimal(smallBlocks_.getLiveCount());
+			writer.append(" (");
+			writer.appendDecimal(smallBlocks_.getLiveBytes());
+			writer.append(" bytes)");
+		}
+		writer.append(".\n");
+
+		// Hold off the mutations while walking the table (a mutex is not async-signal-safe)
+		isDumpingTable_.store(true, std::memory_order_seq_cst);
+		if (!isTableMutating_.load(std::memory_order_seq_cst)) {
+			for (const auto& info : allocTrackData_) {
+				writer.append("Leaked: ");
+				writer.appendDecimal(info.second.size);
+				writer.append(info.second.isArray ? " bytes of an array at " : " bytes at ");
+				writer.appendHex(reinterpret_cast<uintptr_t>(info.first));
+#ifdef _MTP_DEBUG
+				const DebugInfo* debugInfo = debugTrackData_.get(info.first);
+				if (debugInfo != nullptr && debugInfo->file != nullptr) {
+					writer.append(" in ");
+					writer.append(debugInfo->file);
+					if (debugInfo->line != -1) {
+						writer.append(" (line:");
+						writer.appendDecimal(static_cast<uint64_t>(debugInfo->line));
+						writer.append(")");
+					}
+				}
+#endif // _MTP_DEBUG
+				writer.append(".\n");
+			}
+		}
+		else {
+			writer.append("(tracking table busy, records skipped)\n");
+		}
+		isDumpingTable_.store(false, std::memory_order_release);
+
+		writer.flush();
+		isDumping = false;
+	};
+
+	// Install signal handlers dumping the global tracker report into a file descriptor (opt-in)
+	//   - onDemandSignal: dump and continue (e.g. SIGUSR1), 0 to skip
+	//   - isCrashDump: dump on SIGSEGV/SIGBUS/SIGILL/SIGFPE/SIGABRT, then re-raise with the default action
+	static void installSignalReportHandlers(int fd = 2, int onDemandSignal = MTP_DEFAULT_DUMP_SIGNAL, bool isCrashDump = true) {
+		signalReportFd() = fd;
+		if (onDemandSignal != 0)
+			installSignalHandler(onDemandSignal, false);
+		if (isCrashDump) {
+			installSignalHandler(SIGSEGV, true);
+			installSignalHandler(SIGILL, true);
+			installSignalHandler(SIGFPE, true);
+			installSignalHandler(SIGABRT, true);
+#ifdef SIGBUS
+			installSignalHandler(SIGBUS, true);
+#endif // SIGBUS
+		}
+	};
+
+	// Subscribe to tracked allocations, return the hook id (0 if no more hook can be added)
+	HookId addAllocHook(AllocHook hook, void* context = nullptr) {
+		return addHook(allocHooks_, hook, context);
+	};
+
+	// Subscribe to tracked deallocations, return the hook id (0 if no more hook can be added)
+	HookId addFreeHook(FreeHook hook, void* context = nullptr) {
+		return addHook(freeHooks_, hook, context);
+	};
+
+	// Unsubscribe an allocation/deallocation hook, return false if the hook id is unknown
+	bool removeHook(HookId hookId) {
+		return removeHook(allocHooks_, hookId) || removeHook(freeHooks_, hookId);
+	};
+
+	// Get a small index identifying the calling thread (as passed to the hooks)
+	_NODISCARD static uint32_t getThreadIndex(void) noexcept {
+		static std::atomic<uint32_t> nextThreadIndex(0);
+		thread_local uint32_t threadIndex = nextThreadIndex.fetch_add(1, std::memory_order_relaxed);
+		return threadIndex;
+	};
+
+#ifdef _MTP_FLIGHT_RECORDER
+	struct FlightEvent {						// Struct to hold an allocation event of the flight recorder
+		uint64_t	timestamp = 0;				// Steady clock time (in nanoseconds)
+		void*		address = nullptr;
+		size_t		size = 0;					// Block size (0 for a free of an untracked block)
+		DebugInfo	callsite;
+		uint32_t	threadIndex = 0;			// Index of the recording thread ring
+		bool		isFree = false;
+		bool		isArray = false;
+		bool		isTracked = false;			// False for a free of an unknown block (e.g. a double free)
+	};
+	using FlightEvents		= typename std::vector<FlightEvent, InternalAllocator<FlightEvent>>;
+
+	// Enable/disable the flight recorder at runtime (enabled by default)
+	static void setFlightRecorderEnabled(bool isEnabled) noexcept {
+		FlightRecorder::isEnabled().store(isEnabled, std::memory_order_relaxed);
+	};
+
+	// Get the last allocation events of all threads, merged in time order (the last one is the most recent)
+	_NODISCARD static FlightEvents getFlightRecord(void) {
+		FlightEvents events;
+		for (auto* ring = FlightRecorder::rings().load(std::memory_order_acquire); ring != nullptr; ring = ring->next) {
+			const uint64_t head = ring->head.load(std::memory_order_acquire);
+			const uint64_t first = (head > FlightRecorder::RING_SIZE) ? head - FlightRecorder::RING_SIZE : 0;
+			const size_t ringStart = events.size();
+			for (uint64_t pos = first; pos < head; ++pos) {
+				const auto& slot = ring->slots[pos % FlightRecorder::RING_SIZE];
+				const uint32_t flags = slot.flags.load(std::memory_order_relaxed);
+				FlightEvent event;
+				event.timestamp = slot.timestamp.load(std::memory_order_relaxed);
+				event.address = reinterpret_cast<void*>(slot.address.load(std::memory_order_relaxed));
+				event.size = slot.size.load(std::memory_order_relaxed);
+				event.callsite = { slot.file.load(std::memory_order_relaxed), slot.line.load(std::memory_order_relaxed) };
+				event.threadIndex = ring->index;
+				event.isFree = (flags & FlightRecorder::FLAG_FREE) != 0;
+				event.isArray = (flags & FlightRecorder::FLAG_ARRAY) != 0;
+				event.isTracked = (flags & FlightRecorder::FLAG_TRACKED) != 0;
+				events.push_back(event);
+			}
+
+			// Drop the slots which were overwritten while being copied
+			const uint64_t headAfter = ring->head.load(std::memory_order_acquire);
+			if (headAfter >= first + FlightRecorder::RING_SIZE) {
+				const uint64_t overwritten = headAfter - FlightRecorder::RING_SIZE + 1 - first;
+				const size_t dropCount = static_cast<size_t>((overwritten < head - first) ? overwritten : head - first);
+				events.erase(events.begin() + ringStart, events.begin() + ringStart + dropCount);
+			}
+		}
+		std::stable_sort(events.begin(), events.end(), [](const FlightEvent& lhs, const FlightEvent& rhs) {
+			return lhs.timestamp < rhs.timestamp;
+		});
+		return events;
+	};
+
+	// Print the last allocation events of all threads, in time order (lastCount 0 prints all recorded events)
+	static void printFlightRecord(std::ostream& os, size_t lastCount = 0) {
+		const FlightEvents events = getFlightRecord();
+		const size_t first = (lastCount != 0 && lastCount < events.size()) ? events.size() - lastCount : 0;
+		os << "\n--- Flight Recorder: last " << (events.size() - first) << " allocation events ---\n";
+		for (size_t idx = first; idx < events.size(); ++idx) {
+			const FlightEvent& event = events[idx];
+			os << "  [" << event.timestamp << " ns] thread #" << event.threadIndex
+				<< (event.isFree ? (event.isTracked ? " freed " : " freed untracked block at ") : " allocated ");
+			if (event.isTracked)
+				os << event.size << " bytes " << (event.isArray ? "of an array " : "") << "at ";
+			os << event.address;
+			if (event.callsite.file != nullptr)
+				os << " in " << event.callsite.file << " (line:" << event.callsite.line << ")";
+			os << ".\n";
+		}
+	};
+#endif // _MTP_FLIGHT_RECORDER
+
+	// Persistent state file layout (the header is followed by the callsite table, then by the event ring)
+	// Note: Every field is written with a single aligned store and each table slot is published last,
+	//		 so the file stays consistent when the process is killed, without any msync on the hot path.
+	struct PersistentHeader {					// Struct to hold the persistent state header and counters
+		char					magic[8];		// "MTPSTATE"
+		uint32_t				version;
+		uint32_t				headerSize;
+		uint32_t				callsiteSize;
+		uint32_t				callsiteCapacity;
+		uint32_t				eventSize;
+		uint32_t				eventCapacity;
+		uint64_t				processId;
+		std::atomic<uint64_t>	liveCount;
+		std::atomic<uint64_t>	liveBytes;
+		std::atomic<uint64_t>	peakBytes;
+		std::atomic<uint64_t>	totalAllocs;
+		std::atomic<uint64_t>	totalFrees;
+		std::atomic<uint64_t>	eventCount;		// Number of events ever written into the ring
+		std::atomic<uint32_t>	callsiteCount;
+		std::atomic<uint32_t>	isReady;		// Set once the layout is initialized
+	};
+	struct PersistentCallsite {					// Struct to hold the persistent counters of a callsite (slot 0: unknown/overflow)
+		std::atomic<uint32_t>	isReady;		// Set once the slot is published
+		int32_t					line;
+		uint64_t				fileKey;		// Address of the file name in the tracked process
+		std::atomic<uint64_t>	liveCount;
+		std::atomic<uint64_t>	liveBytes;
+		std::atomic<uint64_t>	totalAllocs;
+		char					file[88];		// File name (truncated)
+	};
+	struct PersistentEvent {					// Struct to hold a recent allocation event of the ring
+		std::atomic<uint64_t>	sequence;		// Event number + 1 (0 while the slot is being written)
+		uint64_t				address;
+		uint64_t				size;
+		uint32_t				callsite;		// Callsite slot index
+		uint32_t				isFree;
+	};
+
+	// Keep the tracker counters, the callsite table and optionally a ring of the last events
+	// in a shared file mapping, which can still be read (printPersistentState) after the process is killed
+	// Note: Not supported on Windows
+	bool enablePersistentState(const char* path, uint32_t callsiteCapacity = 4096, uint32_t eventCapacity = 0) {
+#ifdef _MTP_THREADSAFETY
+		MutexLockGuard lock(myMutex_);
+#endif // _MTP_THREADSAFETY
+		persistentState_.close();
+		if (!persistentState_.open(path, callsiteCapacity, eventCapacity)) return false;
+
+		// Seed the state with the blocks which are already live
+		forEachLiveLocked([this](const AllocRecord& record) {
+			persistentState_.onAlloc(record.address, record.size, record.callsite, false);
+		});
+		return true;
+	};
+
+	// Stop updating the persistent state file (the file is left as is)
+	void disablePersistentState(void) {
+#ifdef _MTP_THREADSAFETY
+		MutexLockGuard lock(myMutex_);
+#endif // _MTP_THREADSAFETY
+		persistentState_.close();
+	};
+
+	// Print the heap composition recorded in a persistent state file (also works after the process was killed)
+	static bool printPersistentState(const char* path, std::ostream& os) {
+#ifdef _WIN32
+		(void)path; (void)os;
+		return false;
+#else
+		int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+		if (fd < 0) return false;
+		struct stat fileStat;
+		void* mapping = MAP_FAILED;
+		if (::fstat(fd, &fileStat) == 0 && static_cast<size_t>(fileStat.st_size) >= sizeof(PersistentHeader))
+			mapping = ::mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_SHARED, fd, 0);
+		::close(fd);
+		if (mapping == MAP_FAILED) return false;
+
+		const PersistentHeader* header = static_cast<const PersistentHeader*>(mapping);
+		const size_t mappedSize = static_cast<size_t>(fileStat.st_size);
+		bool isValid = std::memcmp(header->magic, "MTPSTATE", 8) == 0 && header->version == PersistentState::VERSION
+			&& header->isReady.load(std::memory_order_acquire) != 0
+			&& header->callsiteSize == sizeof(PersistentCallsite) && header->eventSize == sizeof(PersistentEvent)
+			&& PersistentState::mappingSize(header->callsiteCapacity, header->eventCapacity) <= mappedSize;
+		if (isValid) {
+			const PersistentCallsite* callsites = PersistentState::callsiteTable(mapping);
+			const PersistentEvent* events = PersistentState::eventRing(mapping, header->callsiteCapacity);
+			os << "\n--- Persistent Memory Tracking State (process " << header->processId << ") ---\n"
+				<< "Live blocks: " << header->liveCount.load() << ", live bytes: " << header->liveBytes.load()
+				<< ", peak bytes: " << header->peakBytes.load() << ".\n"
+				<< "Allocations: " << header->totalAllocs.load() << ", deallocations: " << header->totalFrees.load() << ".\n";
+			for (uint32_t idx = 0; idx < header->callsiteCapacity; ++idx) {
+				const PersistentCallsite& callsite = callsites[idx];
+				if (callsite.isReady.load(std::memory_order_acquire) == 0 || callsite.liveCount.load() == 0) continue;
+				os << "  " << callsite.liveBytes.load() << " bytes in " << callsite.liveCount.load() << " blocks";
+				if (idx == 0)
+					os << " from unknown callsites.\n";
+				else
+					os << " in " << callsite.file << " (line:" << callsite.line << ").\n";
+			}
+			const uint64_t eventCount = header->eventCount.load(std::memory_order_acquire);
+			if (header->eventCapacity != 0 && eventCount != 0) {
+				os << "Last events:\n";
+				uint64_t first = (eventCount > header->eventCapacity) ? eventCount - header->eventCapacity : 0;
+				for (uint64_t seq = first; seq < eventCount; ++seq) {
+					const PersistentEvent& event = events[seq % header->eventCapacity];
+					if (event.sequence.load(std::memory_order_acquire) != seq + 1) continue;	// Torn or overwritten
+					os << "  #" << seq << (event.isFree ? " free " : " alloc ") << event.size << " bytes at 0x"
+						<< std::hex << event.address << std::dec << ".\n";
+				}
+			}
+		}
+		::munmap(mapping, mappedSize);
+		return isValid;
+#endif // _WIN32
+	};
+
+private:
+#ifdef SIGUSR1
+	static constexpr int MTP_DEFAULT_DUMP_SIGNAL = SIGUSR1;
+#else
+	static constexpr int MTP_DEFAULT_DUMP_SIGNAL = 0;
+#endif // SIGUSR1
+
+	// File descriptor of the signal dumps
+	_NODISCARD static int& signalReportFd(void) noexcept {
+		static int fd = 2;
+		return fd;
+	};
+
+	// Install one signal dump handler
+	static void installSignalHandler(int signalNumber, bool isCrash) {
+#ifdef _WIN32
+		std::signal(signalNumber, isCrash ? &crashSignalHandler : &dumpSignalHandler);
+#else
+		struct sigaction action;
+		std::memset(&action, 0, sizeof(action));
+		sigemptyset(&action.sa_mask);
+		action.sa_handler = isCrash ? &crashSignalHandler : &dumpSignalHandler;
+		action.sa_flags = isCrash ? (SA_RESETHAND | SA_NODEFER) : SA_RESTART;
+		sigaction(signalNumber, &action, nullptr);
+#endif // _WIN32
+	};
+
+	// On-demand dump signal handler
+	static void dumpSignalHandler(int signalNumber) {
+		int savedErrno = errno;
+		MemTrackifyPlus* allocTracker = getGlobalMemTrackerSignalSafe();
+		if (allocTracker) allocTracker->dumpTrackingReportSignalSafe(signalReportFd(), signalNumber);
+#ifdef _WIN32
+		std::signal(signalNumber, &dumpSignalHandler);	// Handlers are reset on Windows
+#endif // _WIN32
+		errno = savedErrno;
+	};
+
+	// Crash signal handler, dumps then re-raises the signal with its default action
+	static void crashSignalHandler(int signalNumber) {
+		MemTrackifyPlus* allocTracker = getGlobalMemTrackerSignalSafe();
+		if (allocTracker) allocTracker->dumpTrackingReportSignalSafe(signalReportFd(), signalNumber);
+#ifndef _WIN32
+		signal(signalNumber, SIG_DFL);
+#endif // !_WIN32
+		std::raise(signalNumber);
+	};
+
+	// Access the global tracker from a signal handler
+	_NODISCARD static MemTrackifyPlus* getGlobalMemTrackerSignalSafe(void) noexcept;
+
+private:
+	// No copyable
 	MemTrackifyPlus(const MemTrackifyPlus&) = delete;
 	MemTrackifyPlus& operator=(const MemTrackifyPlus&) = delete;
 
-	// No movable
-	MemTrackifyPlus(const MemTrackifyPlus&&) = delete;
-	MemTrackifyPlus& operator=(const MemTrackifyPlus&&) = delete;
+	// No movable
+	MemTrackifyPlus(const MemTrackifyPlus&&) = delete;
+	MemTrackifyPlus& operator=(const MemTrackifyPlus&&) = delete;
+
+private:
+	// Immutable list of allocation/deallocation hooks
+	struct HookList {
+		struct Entry {
+			HookId		id;
+			AllocHook	hook;
+			void*		context;
+		};
+		size_t		count;
+		HookList*	nextRetired;
+		Entry		entries[MAX_HOOKS];
+	};
+
+	// Header in front of a small block
+	struct alignas(std::max_align_t) SmallBlockHeader {
+		uint32_t	groupIndex;				// Index of the callsite/size class group
+		uint32_t	size;					// Requested block size
+	};
+
+	// Exact set of the live small block addresses, so that a header is only read in front of a block carrying one
+	// Note: Open addressing with linear probing, at most half full (up to 16 bytes per small block)
+	class SmallBlockSet {
+	public:
+		// Construction
+		explicit SmallBlockSet(std::atomic<size_t>* overheadCounters) : slots_(SlotData::allocator_type(overheadCounters)) {};
+
+		// Operations (the caller holds the tracker lock)
+		void reserve(size_t count) {
+			if ((count_ + count) * 2 <= slots_.size()) return;
+			size_t capacity = (slots_.size() != 0) ? slots_.size() : MIN_CAPACITY;
+			while (capacity < (count_ + count) * 2) capacity *= 2;
+			SlotData slots(capacity, 0, slots_.get_allocator());
+			slots.swap(slots_);
+			for (const uintptr_t address : slots)
+				if (address != 0) slots_[findSlot(address)] = address;
+		};
+		void insert(const void* ptr) noexcept {			// The caller reserved the entry
+			const uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+			slots_[findSlot(address)] = address;
+			++count_;
+		};
+		_NODISCARD bool contains(const void* ptr) const noexcept {
+			if (count_ == 0) return false;
+			const uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+			return slots_[findSlot(address)] == address;
+		};
+		_NODISCARD size_t getMemory(void) const noexcept {
+			return slots_.capacity() * sizeof(uintptr_t);
+		};
+		_NODISCARD bool erase(const void* ptr) noexcept {
+			if (count_ == 0) return false;
+			const uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+			size_t hole = findSlot(address);
+			if (slots_[hole] != address) return false;
+
+			// Shift back the following entries of the probe sequence
+			const size_t mask = slots_.size() - 1;
+			for (size_t next = (hole + 1) & mask; slots_[next] != 0; next = (next + 1) & mask) {
+				const size_t home = getHomeSlot(slots_[next]);
+				if (((next - home) & mask) >= ((next - hole) & mask)) {
+					slots_[hole] = slots_[next];
+					hole = next;
+				}
+			}
+			slots_[hole] = 0;
+			--count_;
+			return true;
+		};
+
+	private:
+		static constexpr size_t MIN_CAPACITY = 64;
+		using SlotData = typename std::vector<uintptr_t, InternalAllocator<uintptr_t, OverheadCategory::Callsites>>;
+
+		_NODISCARD size_t getHomeSlot(uintptr_t address) const noexcept {
+			return static_cast<size_t>((static_cast<uint64_t>(address) * 0x9E3779B97F4A7C15ull) >> 16) & (slots_.size() - 1);
+		};
+		// Slot of an address, or the empty slot ending its probe sequence
+		_NODISCARD size_t findSlot(uintptr_t address) const noexcept {
+			const size_t mask = slots_.size() - 1;
+			size_t slot = getHomeSlot(address);
+			while (slots_[slot] != 0 && slots_[slot] != address) slot = (slot + 1) & mask;
+			return slot;
+		};
+
+	private:
+		SlotData	slots_;					// Addresses (0: empty slot), power of two size
+		size_t		count_ = 0;
+	};
+
+	// Slabs of the blocks allocated once the tracker memory limit is reached, counted per callsite without any per-address entry
+	// Note: A block is found through the directory of the slabs (SLAB_SIZE aligned), its slab keeps the group and size of
+	//		 each slot. A slab holds the slots of one size class, a block beyond MAX_SLOT_SIZE gets a slab of its own.
+	//		 Empty slabs are released, except the last one of each size class.
+	class OverflowSlabs {
+	public:
+		static constexpr size_t SLAB_SIZE = 64 * 1024;
+		static constexpr size_t MIN_SLOT_SIZE = 16;
+		static constexpr size_t MAX_SLOT_SIZE = 8 * 1024;
+		static constexpr size_t CLASS_COUNT = 10;			// Slot sizes from MIN_SLOT_SIZE to MAX_SLOT_SIZE (powers of two)
+
+		// Construction
+		explicit OverflowSlabs(std::atomic<size_t>* overheadCounters) : directory_(overheadCounters), overheadCounters_(overheadCounters) {};
+		~OverflowSlabs() {
+			// The slabs still holding live blocks are left to the system
+			for (size_t classIndex = 0; classIndex < CLASS_COUNT; ++classIndex) {
+				Slab* slab = partialSlabs_[classIndex];
+				while (slab != nullptr) {
+					Slab* next = slab->next;
+					if (slab->liveCount == 0) destroySlab(slab);
+					slab = next;
+				}
+			}
+		};
+
+		// Operations (the caller holds the tracker lock)
+		void reserve(void) { directory_.reserve(1); };		// Room for a new slab
+		_NODISCARD void* allocate(size_t size, uint32_t groupIndex) noexcept {
+			const size_t classIndex = getClassIndex(size);
+			Slab* slab = (classIndex < CLASS_COUNT) ? partialSlabs_[classIndex] : nullptr;
+			if (slab == nullptr && (slab = createSlab(classIndex, size)) == nullptr) return nullptr;
+			SlotInfo* slotInfos = getSlotInfos(slab);
+			uint32_t slot = slab->freeIndex;
+			if (slot != NO_SLOT) slab->freeIndex = slotInfos[slot].groupIndex;
+			else slot = slab->bumpIndex++;
+			slotInfos[slot] = { groupIndex, static_cast<uint32_t>(size) };
+			if (++slab->liveCount == slab->slotCount && slab->classIndex < CLASS_COUNT) unlinkSlab(slab);
+			return reinterpret_cast<unsigned char*>(slab) + slab->slotsOffset + static_cast<size_t>(slot) * slab->slotSize;
+		};
+		// Release a block, return false if it is not a live block of the slabs
+		_NODISCARD bool release(const void* ptr, uint32_t& groupIndex, uint32_t& size) noexcept {
+			const uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+			Slab* slab = reinterpret_cast<Slab*>(address & ~static_cast<uintptr_t>(SLAB_SIZE - 1));
+			if (!directory_.contains(slab)) return false;
+			const uintptr_t slotsBegin = reinterpret_cast<uintptr_t>(slab) + slab->slotsOffset;
+			if (address < slotsBegin || (address - slotsBegin) % slab->slotSize != 0) return false;
+			const size_t slot = static_cast<size_t>((address - slotsBegin) / slab->slotSize);
+			SlotInfo* slotInfos = getSlotInfos(slab);
+			if (slot >= slab->bumpIndex || slotInfos[slot].size == 0) return false;
+			groupIndex = slotInfos[slot].groupIndex;
+			size = slotInfos[slot].size;
+			slotInfos[slot] = { slab->freeIndex, 0 };
+			slab->freeIndex = static_cast<uint32_t>(slot);
+			if (slab->classIndex == CLASS_COUNT) {
+				destroySlab(slab);
+				return true;
+			}
+			if (slab->liveCount-- == slab->slotCount) linkSlab(slab);
+			if (slab->liveCount == 0 && (slab->prev != nullptr || slab->next != nullptr)) destroySlab(slab);
+			return true;
+		};
+
+	private:
+		static constexpr uint32_t NO_SLOT = ~static_cast<uint32_t>(0);
+		struct Slab {						// Header at the start of a slab
+			Slab*		prev;					// Slabs of the size class with free slots
+			Slab*		next;
+			size_t		slotsOffset;			// Offset of the first slot
+			uint32_t	classIndex;				// CLASS_COUNT: a single block beyond MAX_SLOT_SIZE
+			uint32_t	slotSize;
+			uint32_t	slotCount;
+			uint32_t	liveCount;
+			uint32_t	bumpIndex;				// The slots from here were never used
+			uint32_t	freeIndex;				// First freed slot (NO_SLOT: none)
+		};
+		struct SlotInfo {					// Following the header, one per slot
+			uint32_t	groupIndex;				// Group of the block (next freed slot once free)
+			uint32_t	size;					// Requested block size (0: free slot)
+		};
+
+		_NODISCARD static size_t getClassIndex(size_t size) noexcept {
+			size_t classIndex = 0;
+			for (size_t slotSize = MIN_SLOT_SIZE; slotSize < size && classIndex < CLASS_COUNT; slotSize <<= 1) ++classIndex;
+			return classIndex;
+		};
+		_NODISCARD static size_t getSlotsOffset(size_t slotCount) noexcept {
+			const size_t align = alignof(std::max_align_t);
+			return (sizeof(Slab) + slotCount * sizeof(SlotInfo) + align - 1) & ~(align - 1);
+		};
+		_NODISCARD static SlotInfo* getSlotInfos(Slab* slab) noexcept {
+			return reinterpret_cast<SlotInfo*>(slab + 1);
+		};
+
+		_NODISCARD Slab* createSlab(size_t classIndex, size_t size) noexcept {
+			const bool isSingle = (classIndex == CLASS_COUNT);
+			const size_t slotSize = isSingle ? size : (MIN_SLOT_SIZE << classIndex);
+			size_t slotCount = isSingle ? 1 : (SLAB_SIZE - sizeof(Slab)) / (slotSize + sizeof(SlotInfo));
+			while (!isSingle && getSlotsOffset(slotCount) + slotCount * slotSize > SLAB_SIZE) --slotCount;
+			const size_t slotsOffset = getSlotsOffset(slotCount);
+			if (isSingle && size > SIZE_LIMIT - slotsOffset) return nullptr;
+			void* storage = AllocatorBackend::alignedAllocate(isSingle ? slotsOffset + size : SLAB_SIZE, SLAB_SIZE);
+			if (storage == nullptr) return nullptr;
+			Slab* slab = ::new(storage) Slab{ nullptr, nullptr, slotsOffset, static_cast<uint32_t>(classIndex), static_cast<uint32_t>(slotSize),
+											  static_cast<uint32_t>(slotCount), 0, 0, NO_SLOT };
+			directory_.insert(slab);
+			if (!isSingle) linkSlab(slab);
+			overheadCounters_[static_cast<size_t>(OverheadCategory::Callsites)].fetch_add(slotsOffset, std::memory_order_relaxed);
+			return slab;
+		};
+		void destroySlab(Slab* slab) noexcept {
+			if (slab->classIndex < CLASS_COUNT) unlinkSlab(slab);
+			(void)directory_.erase(slab);
+			overheadCounters_[static_cast<size_t>(OverheadCategory::Callsites)].fetch_sub(slab->slotsOffset, std::memory_order_relaxed);
+			AllocatorBackend::alignedDeallocate(slab);
+		};
+		void linkSlab(Slab* slab) noexcept {
+			Slab*& head = partialSlabs_[slab->classIndex];
+			slab->prev = nullptr;
+			slab->next = head;
+			if (head != nullptr) head->prev = slab;
+			head = slab;
+		};
+		void unlinkSlab(Slab* slab) noexcept {
+			if (slab->prev != nullptr) slab->prev->next = slab->next;
+			else partialSlabs_[slab->classIndex] = slab->next;
+			if (slab->next != nullptr) slab->next->prev = slab->prev;
+			slab->prev = slab->next = nullptr;
+		};
+
+	private:
+		SmallBlockSet			directory_;							// Addresses of the slabs
+		Slab*					partialSlabs_[CLASS_COUNT] = {};	// Slabs with free slots, per size class
+		std::atomic<size_t>*	overheadCounters_;
+	};
+
+	// Live counters of the small blocks per callsite/size class (fixed capacity, allocated with the first small block)
+	// Note: A group is recycled once its last block is freed. The overflow group collects the blocks of the callsites
+	//		 finding no group within MAX_PROBES groups, it is reported with the largest size class it holds.
+	class SmallBlockTable {
+	public:
+		static constexpr uint32_t CAPACITY = 1024;
+		static constexpr uint32_t OVERFLOW_INDEX = CAPACITY - 1;
+		static constexpr uint32_t MAX_PROBES = 64;		// Groups probed per lookup
+
+		// Construction
+		explicit SmallBlockTable(std::atomic<size_t>* overheadCounters) noexcept : overheadCounters_(overheadCounters) {};
+		~SmallBlockTable() {
+			if (groups_ == nullptr) return;
+			std::free(groups_);
+			overheadCounters_[static_cast<size_t>(OverheadCategory::Callsites)].fetch_sub(getHeapBlockCost(sizeof(Group) * CAPACITY), std::memory_order_relaxed);
+		};
+
+		// Allocate the groups, before the first block is counted
+		void reserve(void) {
+			if (groups_ != nullptr) return;
+			groups_ = static_cast<Group*>(std::calloc(CAPACITY, sizeof(Group)));
+			if (groups_ == nullptr) throw std::bad_alloc();
+			overheadCounters_[static_cast<size_t>(OverheadCategory::Callsites)].fetch_add(getHeapBlockCost(sizeof(Group) * CAPACITY), std::memory_order_relaxed);
+		};
+
+		// Count a new block, return its group index
+		uint32_t add(const char* file, int line, size_t size) noexcept {
+			const size_t sizeClass = (size + 7) & ~static_cast<size_t>(7);
+			const size_t hash = std::hash<const void*>()(file) ^ (static_cast<size_t>(line) * 31) ^ (sizeClass * 0x9E3779B9u);
+			uint32_t index = OVERFLOW_INDEX;
+			uint32_t freeIndex = OVERFLOW_INDEX;
+			for (uint32_t probe = 0; probe < MAX_PROBES; ++probe) {
+				const uint32_t slot = static_cast<uint32_t>((hash + probe) % OVERFLOW_INDEX);
+				const Group& group = groups_[slot];
+				if (group.sizeClass == 0 || group.sizeClass == RECYCLED_GROUP) {
+					if (freeIndex == OVERFLOW_INDEX) freeIndex = slot;
+					if (group.sizeClass == 0) break;		// End of the probe sequence
+				}
+				else if (group.file == file && group.line == line && group.sizeClass == sizeClass) {
+					index = slot;
+					break;
+				}
+			}
+			if (index == OVERFLOW_INDEX && freeIndex != OVERFLOW_INDEX) {
+				index = freeIndex;
+				groups_[index] = { file, line, sizeClass, 0, 0 };
+			}
+
+			Group& group = groups_[index];
+			if (index == OVERFLOW_INDEX && sizeClass > group.sizeClass) group.sizeClass = sizeClass;
+			++group.count;
+			group.bytes += size;
+			++liveCount_;
+			liveBytes_ += size;
+			return index;
+		};
+
+		// Uncount a freed block
+		void remove(uint32_t index, size_t size) noexcept {
+			Group& group = groups_[index];
+			--group.count;
+			group.bytes -= size;
+			--liveCount_;
+			liveBytes_ -= size;
+			if (group.count == 0 && index != OVERFLOW_INDEX) recycleGroup(index);
+		};
+
+		// Visit the groups with live blocks
+		template<typename _Visitor>
+		void forEach(_Visitor&& visitor) const {
+			if (liveCount_ == 0) return;
+			for (uint32_t index = 0; index < CAPACITY; ++index) {
+				const Group& group = groups_[index];
+				if (group.count == 0) continue;
+				LeakGroup leakGroup;
+				if (index != OVERFLOW_INDEX) leakGroup.callsite = { group.file, group.line };
+				else leakGroup.callsite = { "(other callsites)", -1 };
+				leakGroup.blockSize = group.sizeClass;
+				leakGroup.count = group.count;
+				leakGroup.bytes = group.bytes;
+				visitor(leakGroup);
+			}
+		};
+
+		// Attributes
+		_NODISCARD size_t getLiveCount(void) const noexcept { return liveCount_; };
+		_NODISCARD size_t getLiveBytes(void) const noexcept { return liveBytes_; };
+
+	private:
+		struct Group {
+			const char*	file;
+			int			line;
+			size_t		sizeClass;			// 0 for an unused group, RECYCLED_GROUP for a recycled one
+			size_t		count;
+			size_t		bytes;
+		};
+		static constexpr size_t RECYCLED_GROUP = ~static_cast<size_t>(0);
+
+		// Recycle a group without live blocks, it stays in the probe sequences of the next groups
+		// (unused again once no later group of the sequence depends on it)
+		void recycleGroup(uint32_t index) noexcept {
+			groups_[index].sizeClass = RECYCLED_GROUP;
+			if (groups_[(index + 1) % OVERFLOW_INDEX].sizeClass != 0) return;
+			while (groups_[index].sizeClass == RECYCLED_GROUP) {
+				groups_[index].sizeClass = 0;
+				index = (index + OVERFLOW_INDEX - 1) % OVERFLOW_INDEX;
+			}
+		};
+
+		Group*			groups_ = nullptr;		// CAPACITY groups, the last one collects the overflow
+		std::atomic<size_t>*	overheadCounters_;
+		size_t			liveCount_ = 0;
+		size_t			liveBytes_ = 0;
+	};
+
+#ifdef _MTP_GROWTH_TRACKING
+	// Detects the buffers grown by alloc-copy-free cycles (vectors, string builders, ...) and follows them in chains
+	// Note: A growth step is the free of a block from a callsite, right after or right before (on the same thread,
+	//		 no other tracked operation in between) a larger allocation from the same callsite. The chain then moves
+	//		 to the new block, and ends when its block is freed without growing. All calls hold the tracker lock.
+	class GrowthTracker {
+	public:
+		// Construction
+		explicit GrowthTracker(std::atomic<size_t>* overheadCounters)
+			: chains_(typename GrowthChainData::allocator_type(overheadCounters)), sites_(typename GrowthSiteData::allocator_type(overheadCounters)) {};
+
+		// Record a tracked allocation
+		void onAlloc(Address ptr, size_t size, const DebugInfo& callsite) noexcept {
+			LastEvent& last = lastEvent();
+			try {
+				// Growth step: the previous free of this thread outgrew its block
+				const bool isGrowth = last.owner == this && last.kind == EventKind::Free
+					&& isSameCallsite(last.callsite, callsite) && last.size < size;
+				GrowthChain chain;
+				if (isGrowth) chain = takePendingChain(last);
+				else finishPendingChain(last);
+
+				// A stale chain left on a reused address (freed by another thread) ends now
+				if (!chains_.empty()) finishChain(chains_.find(ptr));
+				if (isGrowth) {
+					growChain(chain, callsite, last.size, ptr, size);
+					last.kind = EventKind::None;
+					return;
+				}
+			}
+			catch (...) {}					// Tracker out of memory, the event is lost
+			last = { this, EventKind::Alloc, callsite, ptr, size, 0 };
+		};
+
+		// Record a tracked deallocation
+		void onFree(Address ptr, size_t size, const DebugInfo& callsite) noexcept {
+			LastEvent& last = lastEvent();
+			uint64_t serial = 0;
+			try {
+				// Growth step: the previous allocation of this thread replaces the freed block
+				auto chainIt = chains_.empty() ? chains_.end() : chains_.find(ptr);
+				if (last.owner == this && last.kind == EventKind::Alloc && isSameCallsite(last.callsite, callsite)
+					&& last.size > size && last.ptr != ptr) {
+					GrowthChain chain;
+					if (chainIt != chains_.end()) {
+						chain = chainIt->second;
+						chains_.erase(chainIt);
+					}
+					growChain(chain, callsite, size, last.ptr, last.size);
+					last.kind = EventKind::None;
+					return;
+				}
+				finishPendingChain(last);
+
+				// The chain may still grow with the next allocation of this thread
+				chainIt = chains_.empty() ? chains_.end() : chains_.find(ptr);
+				if (chainIt != chains_.end()) {
+					chainIt->second.isPending = true;
+					serial = chainIt->second.serial;
+				}
+			}
+			catch (...) {}					// Tracker out of memory, the event is lost
+			last = { this, EventKind::Free, callsite, ptr, size, serial };
+		};
+
+		// Visit the callsites with reallocation chains, the live chains are counted as if they ended now
+		template<typename _Visitor>
+		void forEach(_Visitor&& visitor) const {
+			GrowthSiteData sites(sites_);
+			for (const auto& chain : chains_) addFinishedChain(sites, chain.second);
+			for (const auto& site : sites) {
+				const SiteCounters& counters = site.second;
+				GrowthSite growthSite;
+				growthSite.callsite = { site.first.file, site.first.line };
+				growthSite.chainCount = counters.chainCount;
+				growthSite.reallocations = counters.reallocations;
+				growthSite.bytesCopied = counters.bytesCopied;
+				growthSite.longestChain = counters.longestChain;
+				const size_t covered = (counters.chainCount * 9 + 9) / 10;
+				size_t count = 0;
+				for (size_t sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; ++sizeClass) {
+					if (counters.finalCounts[sizeClass] == 0) continue;
+					growthSite.largestFinalBytes = counters.finalMaxBytes[sizeClass];
+					if (count < covered && (count += counters.finalCounts[sizeClass]) >= covered)
+						growthSite.suggestedCapacity = counters.finalMaxBytes[sizeClass];
+				}
+				visitor(growthSite);
+			}
+		};
+
+	private:
+		enum class EventKind : uint8_t { None, Alloc, Free };
+		struct LastEvent {					// Last tracked operation of the calling thread
+			const GrowthTracker*	owner;
+			EventKind				kind;
+			DebugInfo				callsite;
+			Address					ptr;
+			size_t					size;
+			uint64_t				serial;			// Chain of the freed block (0: none)
+		};
+		struct GrowthChain {				// A buffer followed through its reallocations
+			DebugInfo	callsite;
+			size_t		length = 0;				// Number of growth steps
+			size_t		bytesCopied = 0;
+			size_t		finalBytes = 0;			// Size of the current buffer
+			uint64_t	serial = 0;
+			bool		isPending = false;		// The buffer was freed, the chain ends unless the next allocation outgrows it
+		};
+		struct SiteCounters {				// Counters of the finished chains of a callsite
+			size_t		chainCount = 0;
+			size_t		reallocations = 0;
+			size_t		bytesCopied = 0;
+			size_t		longestChain = 0;
+			size_t		finalCounts[SIZE_CLASS_COUNT] = {};		// Number of chains per final size class
+			size_t		finalMaxBytes[SIZE_CLASS_COUNT] = {};	// Largest final size per size class
+		};
+		using GrowthChainData	= typename std::unordered_map<Address, GrowthChain, std::hash<Address>, std::equal_to<Address>,
+															 InternalAllocator<std::pair<const Address, GrowthChain>, OverheadCategory::Callsites>>;
+		using GrowthSiteData	= typename std::unordered_map<LeakGroupKey, SiteCounters, LeakGroupKeyHash, std::equal_to<LeakGroupKey>,
+															 InternalAllocator<std::pair<const LeakGroupKey, SiteCounters>, OverheadCategory::Callsites>>;
+
+		_NODISCARD static LastEvent& lastEvent(void) noexcept {
+			thread_local LastEvent last = { nullptr, EventKind::None, {}, nullptr, 0, 0 };
+			return last;
+		};
+
+		// Callsites match on the file and line, tags (line -1) on the file alone
+		// Note: Unknown callsites (all of them without _MTP_DEBUG) never match, unrelated blocks would make chains
+		_NODISCARD static bool isSameCallsite(const DebugInfo& lhs, const DebugInfo& rhs) noexcept {
+			return lhs.line == rhs.line && lhs.file == rhs.file && isKnownCallsite(lhs);
+		};
+		_NODISCARD static bool isKnownCallsite(const DebugInfo& callsite) noexcept {
+			return callsite.file != nullptr && (callsite.line != -1 || std::strcmp(callsite.file, "unknown") != 0);
+		};
+		_NODISCARD static LeakGroupKey getSiteKey(const DebugInfo& callsite) noexcept {
+			LeakGroupKey key;
+			key.file = callsite.file;
+			key.line = callsite.line;
+			return key;
+		};
+
+		// Add a growth step to a chain, which moves to the new buffer
+		void growChain(GrowthChain& chain, const DebugInfo& callsite, size_t oldSize, Address newPtr, size_t newSize) {
+			if (chain.serial == 0) {
+				chain.callsite = callsite;
+				chain.serial = ++lastSerial_;
+			}
+			++chain.length;
+			chain.bytesCopied += oldSize;
+			chain.finalBytes = newSize;
+			chain.isPending = false;
+			chains_[newPtr] = chain;
+		};
+
+		// Take the chain of the block freed by the last operation of this thread (a new chain if it ended meanwhile)
+		_NODISCARD GrowthChain takePendingChain(const LastEvent& last) {
+			GrowthChain chain;
+			if (last.serial == 0) return chain;
+			auto chainIt = chains_.find(last.ptr);
+			if (chainIt == chains_.end() || chainIt->second.serial != last.serial) return chain;
+			chain = chainIt->second;
+			chains_.erase(chainIt);
+			return chain;
+		};
+
+		// End the chain of the block freed by the last operation of this thread
+		void finishPendingChain(const LastEvent& last) {
+			if (last.owner != this || last.kind != EventKind::Free || last.serial == 0) return;
+			auto chainIt = chains_.find(last.ptr);
+			if (chainIt != chains_.end() && chainIt->second.serial == last.serial) finishChain(chainIt);
+		};
+
+		void finishChain(typename GrowthChainData::iterator chainIt) {
+			if (chainIt == chains_.end()) return;
+			addFinishedChain(sites_, chainIt->second);
+			chains_.erase(chainIt);
+		};
+
+		static void addFinishedChain(GrowthSiteData& sites, const GrowthChain& chain) {
+			SiteCounters& counters = sites[getSiteKey(chain.callsite)];
+			++counters.chainCount;
+			counters.reallocations += chain.length;
+			counters.bytesCopied += chain.bytesCopied;
+			if (chain.length > counters.longestChain) counters.longestChain = chain.length;
+			const size_t sizeClass = getSizeClassIndex(chain.finalBytes);
+			++counters.finalCounts[sizeClass];
+			if (chain.finalBytes > counters.finalMaxBytes[sizeClass]) counters.finalMaxBytes[sizeClass] = chain.finalBytes;
+		};
+
+		GrowthChainData		chains_;				// Live chains, by current buffer (or by freed buffer while pending)
+		GrowthSiteData		sites_;					// Finished chains, by callsite
+		uint64_t			lastSerial_ = 0;
+	};
+#endif // _MTP_GROWTH_TRACKING
+
+	// Times one tracking operation out of OVERHEAD_SAMPLE_RATE (per thread) to estimate the CPU overhead
+	class OverheadSampler {
+	public:
+		// Construction
+		explicit OverheadSampler(MemTrackifyPlus& tracker) noexcept {
+			thread_local uint32_t operationCount = 0;
+			if ((++operationCount & (OVERHEAD_SAMPLE_RATE - 1)) == 0) {
+				tracker_ = &tracker;
+				start_ = std::chrono::steady_clock::now();
+			}
+		};
+		~OverheadSampler() {
+			if (tracker_ == nullptr) return;
+			const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_);
+			tracker_->sampledOperations_.fetch_add(1, std::memory_order_relaxed);
+			tracker_->sampledNanoseconds_.fetch_add(static_cast<uint64_t>(elapsed.count()), std::memory_order_relaxed);
+		};
+
+	private:
+		// No copyable
+		OverheadSampler(const OverheadSampler&) = delete;
+		OverheadSampler& operator=(const OverheadSampler&) = delete;
+
+	private:
+		MemTrackifyPlus*						tracker_ = nullptr;
+		std::chrono::steady_clock::time_point	start_;
+	};
+
+	// Counting filter of the tracked block addresses, a zero counter proves that a block is not tracked
+	// Note: Updated under the tracker lock and read without it. Counters saturate (and are then never decremented),
+	//		 so a non-zero counter may be a false positive, which only costs the table lookup.
+	//		 The counters are allocated with the first tracked block, if that fails every block may be tracked.
+	class TrackedFilter {
+	public:
+		static constexpr size_t SLOT_BITS = 18;
+		static constexpr size_t SLOT_COUNT = static_cast<size_t>(1) << SLOT_BITS;
+
+		// Construction
+		explicit TrackedFilter(std::atomic<size_t>* overheadCounters) noexcept : overheadCounters_(overheadCounters) {};
+		~TrackedFilter() {
+			std::atomic<uint8_t>* slots = slots_.load(std::memory_order_relaxed);
+			if (slots == nullptr) return;
+			std::free(slots);
+			overheadCounters_[static_cast<size_t>(OverheadCategory::Table)].fetch_sub(getHeapBlockCost(sizeof(*slots) * SLOT_COUNT), std::memory_order_relaxed);
+		};
+
+		// Operations (the caller holds the tracker lock)
+		void insert(const void* ptr) noexcept {
+			std::atomic<uint8_t>* slots = slots_.load(std::memory_order_relaxed);
+			if (slots == nullptr && (slots = allocateSlots()) == nullptr) return;
+			std::atomic<uint8_t>& slot = slots[getSlotIndex(ptr)];
+			const uint8_t count = slot.load(std::memory_order_relaxed);
+			if (count != SATURATED) slot.store(static_cast<uint8_t>(count + 1), std::memory_order_relaxed);
+		};
+		void erase(const void* ptr) noexcept {
+			std::atomic<uint8_t>* slots = slots_.load(std::memory_order_relaxed);
+			if (slots == nullptr) return;
+			std::atomic<uint8_t>& slot = slots[getSlotIndex(ptr)];
+			const uint8_t count = slot.load(std::memory_order_relaxed);
+			if (count != 0 && count != SATURATED) slot.store(static_cast<uint8_t>(count - 1), std::memory_order_relaxed);
+		};
+
+		// Lock-free lookup
+		_NODISCARD bool mayContain(const void* ptr) const noexcept {
+			const std::atomic<uint8_t>* slots = slots_.load(std::memory_order_acquire);
+			if (slots == nullptr) return isSaturated_.load(std::memory_order_relaxed);
+			return slots[getSlotIndex(ptr)].load(std::memory_order_relaxed) != 0;
+		};
+
+		// Hint the counter of a block about to be updated into the cache
+		void prefetch(const void* ptr) const noexcept {
+			const std::atomic<uint8_t>* slots = slots_.load(std::memory_order_relaxed);
+			if (slots != nullptr) _MTP_PREFETCH(&slots[getSlotIndex(ptr)]);
+		};
+
+	private:
+		static constexpr uint8_t SATURATED = 0xFF;
+
+		// Allocate the zeroed counters (the pages are committed as they are used)
+		_NODISCARD std::atomic<uint8_t>* allocateSlots(void) noexcept {
+			if (isSaturated_.load(std::memory_order_relaxed)) return nullptr;
+			std::atomic<uint8_t>* slots = static_cast<std::atomic<uint8_t>*>(std::calloc(SLOT_COUNT, sizeof(std::atomic<uint8_t>)));
+			if (slots == nullptr) {
+				isSaturated_.store(true, std::memory_order_relaxed);
+				return nullptr;
+			}
+			overheadCounters_[static_cast<size_t>(OverheadCategory::Table)].fetch_add(getHeapBlockCost(sizeof(*slots) * SLOT_COUNT), std::memory_order_relaxed);
+			slots_.store(slots, std::memory_order_release);
+			return slots;
+		};
+
+		_NODISCARD static size_t getSlotIndex(const void* ptr) noexcept {
+			const uint64_t address = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(ptr));
+			return static_cast<size_t>((address * 0x9E3779B97F4A7C15ull) >> (64 - SLOT_BITS));
+		};
+
+	private:
+		std::atomic<std::atomic<uint8_t>*>	slots_{ nullptr };		// Counters (allocated with the first tracked block)
+		std::atomic<size_t>*				overheadCounters_;
+		AtomicFlag							isSaturated_{ false };	// The counters could not be allocated
+	};
+
+	// Ensure trackAlloc() function run correctly
+	class AllocGuard {
+	public:
+		// Construction
+		AllocGuard(bool& flag) : myFlag_(flag) { myFlag_ = true; };
+		~AllocGuard() { myFlag_ = false; };
+
+	private:
+		bool& myFlag_;
+	};
+
+	// Mark the tracking table as being modified, so that a signal dump skips walking it
+	// Note: The flag and the dump flag are checked in a crossed order (store then load), so that the signal dump
+	//		 and a mutation never both go ahead. A mutation waits for a dump walking the table on another thread.
+	class TableMutationGuard {
+	public:
+		// Construction
+		TableMutationGuard(AtomicFlag& flag, const AtomicFlag& dumpFlag) : myFlag_(flag) {
+#ifdef _MTP_THREADSAFETY
+			for (;;) {
+				myFlag_.store(true, std::memory_order_seq_cst);
+				if (!dumpFlag.load(std::memory_order_seq_cst)) break;
+				myFlag_.store(false, std::memory_order_seq_cst);
+				while (dumpFlag.load(std::memory_order_relaxed)) std::this_thread::yield();
+			}
+#else
+			(void)dumpFlag;
+			myFlag_.store(true, std::memory_order_relaxed);
+			std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif // _MTP_THREADSAFETY
+		};
+		~TableMutationGuard() {
+			std::atomic_signal_fence(std::memory_order_seq_cst);
+			myFlag_.store(false, std::memory_order_release);
+		};
+
+	private:
+		AtomicFlag& myFlag_;
+	};
+
+	// Async-signal-safe report output into a preallocated buffer, written with write(2)
+	class SignalSafeWriter {
+	public:
+		// Construction
+		SignalSafeWriter(int fd, char* buffer, size_t capacity) noexcept
+			: fd_(fd), buffer_(buffer), capacity_(capacity) {};
+		~SignalSafeWriter() { flush(); };
+
+		// Operations
+		void append(const char* str) noexcept {
+			while (*str != '\0') {
+				if (used_ == capacity_) flush();
+				buffer_[used_++] = *str++;
+			}
+		};
+		void appendDecimal(uint64_t value) noexcept {
+			char digits[20];
+			int count = 0;
+			do { digits[count++] = static_cast<char>('0' + value % 10); value /= 10; } while (value != 0);
+			appendReversed(digits, count);
+		};
+		void appendHex(uintptr_t value) noexcept {
+			static const char hexDigits[] = "0123456789abcdef";
+			char digits[sizeof(uintptr_t) * 2];
+			int count = 0;
+			do { digits[count++] = hexDigits[value & 0xF]; value >>= 4; } while (value != 0);
+			append("0x");
+			appendReversed(digits, count);
+		};
+		void flush(void) noexcept {
+			const char* data = buffer_;
+			while (used_ != 0) {
+#ifdef _WIN32
+				int written = _write(fd_, data, static_cast<unsigned int>(used_));
+#else
+				ssize_t written = ::write(fd_, data, used_);
+				if (written < 0 && errno == EINTR) continue;
+#endif // _WIN32
+				if (written <= 0) break;
+				data += written;
+				used_ -= static_cast<size_t>(written);
+			}
+			used_ = 0;
+		};
+
+	private:
+		void appendReversed(const char* digits, int count) noexcept {
+			while (count > 0) {
+				if (used_ == capacity_) flush();
+				buffer_[used_++] = digits[--count];
+			}
+		};
+
+	private:
+		int		fd_;
+		char*	buffer_;
+		size_t	capacity_;
+		size_t	used_ = 0;
+	};
+
+#ifdef _MTP_FLIGHT_RECORDER
+	// Per-thread rings of the last allocation events (see getFlightRecord)
+	// Note: Each ring is written by its owner thread only, with relaxed (plain) stores and no lock.
+	//		 Readers copy the slots, then discard the ones overwritten meanwhile by checking the ring head again.
+	class FlightRecorder {
+	public:
+		static constexpr size_t RING_SIZE = _MTP_FLIGHT_RECORDER_SIZE;
+
+		enum : uint32_t {
+			FLAG_FREE		= 0x1,
+			FLAG_ARRAY		= 0x2,
+			FLAG_TRACKED	= 0x4,
+		};
+
+		struct Slot {
+			std::atomic<uint64_t>		timestamp;
+			std::atomic<uintptr_t>		address;
+			std::atomic<size_t>			size;
+			std::atomic<const char*>	file;
+			std::atomic<int32_t>		line;
+			std::atomic<uint32_t>		flags;
+		};
+
+		struct Ring {
+			Ring*					next = nullptr;			// Next ring of the registry (rings are never freed)
+			uint32_t				index = 0;				// Ring index (reported as the thread index)
+			std::atomic<bool>		isOwned;				// Check if a live thread owns the ring
+			std::atomic<uint64_t>	head;					// Number of events ever written
+			Slot					slots[RING_SIZE];
+		};
+
+		// Record an event into the ring of the calling thread
+		static void record(const void* ptr, size_t size, const DebugInfo& debugInfo, uint32_t flags) noexcept {
+			if (!isEnabled().load(std::memory_order_relaxed)) return;
+			Ring* ring = threadRing();
+			if (ring == nullptr) return;
+			const uint64_t pos = ring->head.load(std::memory_order_relaxed);
+			Slot& slot = ring->slots[pos % RING_SIZE];
+			slot.timestamp.store(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count()), std::memory_order_relaxed);
+			slot.address.store(reinterpret_cast<uintptr_t>(ptr), std::memory_order_relaxed);
+			slot.size.store(size, std::memory_order_relaxed);
+			slot.file.store(debugInfo.file, std::memory_order_relaxed);
+			slot.line.store(debugInfo.line, std::memory_order_relaxed);
+			slot.flags.store(flags, std::memory_order_relaxed);
+			ring->head.store(pos + 1, std::memory_order_release);
+		};
+
+		// Runtime switch of the recorder (enabled by default)
+		_NODISCARD static std::atomic<bool>& isEnabled(void) noexcept {
+			static std::atomic<bool> isRecorderEnabled(true);
+			return isRecorderEnabled;
+		};
+
+		// Head of the ring registry
+		_NODISCARD static std::atomic<Ring*>& rings(void) noexcept {
+			static std::atomic<Ring*> ringList(nullptr);
+			return ringList;
+		};
+
+	private:
+		// Releases the ring of a thread on thread exit, so that a new thread can reuse it
+		struct RingOwner {
+			Ring* ring = nullptr;
+			~RingOwner() { if (ring) ring->isOwned.store(false, std::memory_order_release); };
+		};
+
+		// Get (or claim) the ring of the calling thread
+		_NODISCARD static Ring* threadRing(void) noexcept {
+			thread_local RingOwner owner;
+			if (owner.ring != nullptr) return owner.ring;
+
+			// Reuse a ring released by an exited thread, or register a new one
+			for (Ring* ring = rings().load(std::memory_order_acquire); ring != nullptr; ring = ring->next) {
+				bool isOwned = false;
+				if (ring->isOwned.compare_exchange_strong(isOwned, true, std::memory_order_acq_rel))
+					return owner.ring = ring;
+			}
+			void* storage = std::calloc(1, sizeof(Ring));
+			if (storage == nullptr) return nullptr;
+			Ring* ring = new(storage) Ring();
+			ring->isOwned.store(true, std::memory_order_relaxed);
+			Ring* head = rings().load(std::memory_order_relaxed);
+			do {
+				ring->next = head;
+				ring->index = (head != nullptr) ? head->index + 1 : 0;
+			} while (!rings().compare_exchange_weak(head, ring, std::memory_order_release, std::memory_order_relaxed));
+			return owner.ring = ring;
+		};
+	};
+#endif // _MTP_FLIGHT_RECORDER
+
+#ifdef _MTP_SMALL_OBJECT_ALLOCATOR
+	// Thread-caching allocator of the small objects (see _MTP_SMALL_OBJECT_ALLOCATOR)
+	// Note: Slots are carved from slabs aligned on their size, the live slots of a slab are tracked by one bit each
+	//		 instead of a tracking table entry. Each thread keeps a magazine of free slots per size class, refilled from
+	//		 and flushed to the central depot in batches. Slabs are never released (shared by all trackers).
+	class SmallObjectAllocator {
+	public:
+		static constexpr size_t MAX_SIZE			= 256;
+		static constexpr size_t SIZE_STEP			= 16;
+		static constexpr size_t CLASS_COUNT			= MAX_SIZE / SIZE_STEP;
+		static constexpr size_t SLAB_SIZE			= 64 * 1024;
+		static constexpr size_t BATCH_SIZE			= 32;				// Slots moved between a magazine and the depot at once
+		static constexpr size_t MAGAZINE_CAPACITY	= 2 * BATCH_SIZE;
+		static constexpr size_t DIRECTORY_BITS		= 16;
+		static constexpr size_t MAX_SLABS			= (static_cast<size_t>(1) << DIRECTORY_BITS) / 2;
+
+		// Allocate a slot for a block of 1 to MAX_SIZE bytes (nullptr once the slabs are exhausted)
+		_NODISCARD static void* allocate(size_t size) noexcept {
+			const size_t classIndex = (size - 1) / SIZE_STEP;
+			ThreadCache& cache = threadCache();
+			Magazine& magazine = cache.magazines[classIndex];
+			if (magazine.head == nullptr && !refill(classIndex, magazine, cache.isClosed ? 1 : BATCH_SIZE)) return nullptr;
+			void* ptr = magazine.head;
+			magazine.head = *static_cast<void**>(ptr);
+			--magazine.count;
+			Slab* slab = getSlab(ptr);
+			const size_t slotIndex = getSlotIndex(slab, ptr);
+			slab->liveBits[slotIndex / 64].fetch_or(static_cast<uint64_t>(1) << (slotIndex % 64), std::memory_order_relaxed);
+			return ptr;
+		};
+
+		// Free a slot, return false if the block does not belong to a slab
+		// Note: Freeing a slot which is not live (double free, interior pointer) is ignored
+		static bool deallocate(void* ptr) noexcept {
+			Slab* slab = findSlab(ptr);
+			if (slab == nullptr) return false;
+			const size_t slotIndex = getSlotIndex(slab, ptr);
+			if (slotIndex >= slab->slotCount || getSlotAddress(slab, slotIndex) != ptr) return true;
+			const uint64_t mask = static_cast<uint64_t>(1) << (slotIndex % 64);
+			if ((slab->liveBits[slotIndex / 64].fetch_and(~mask, std::memory_order_relaxed) & mask) == 0) return true;
+
+			const size_t classIndex = slab->slotSize / SIZE_STEP - 1;
+			ThreadCache& cache = threadCache();
+			Magazine& magazine = cache.magazines[classIndex];
+			*static_cast<void**>(ptr) = magazine.head;
+			magazine.head = ptr;
+			++magazine.count;
+			if (cache.isClosed) flush(classIndex, magazine, magazine.count);
+			else if (magazine.count > MAGAZINE_CAPACITY) flush(classIndex, magazine, BATCH_SIZE);
+			return true;
+		};
+
+		// Check if a block belongs to a slab (lock-free)
+		_NODISCARD static bool owns(const void* ptr) noexcept {
+			return findSlab(ptr) != nullptr;
+		};
+
+		// Visit each live slot: visitor(address, slot size)
+		template<typename _Visitor>
+		static void forEachLive(_Visitor&& visitor) {
+			for (Slab* slab = getState().slabs.load(std::memory_order_acquire); slab != nullptr; slab = slab->next) {
+				for (size_t word = 0; word < BITMAP_WORDS; ++word) {
+					uint64_t bits = slab->liveBits[word].load(std::memory_order_relaxed);
+					for (size_t bit = 0; bits != 0; ++bit, bits >>= 1) {
+						if (bits & 1) visitor(getSlotAddress(slab, word * 64 + bit), static_cast<size_t>(slab->slotSize));
+					}
+				}
+			}
+		};
+
+		// Count the slabs and the live slots (scans the slab bitmaps)
+		_NODISCARD static SmallObjectStats getStats(void) noexcept {
+			SmallObjectStats stats;
+			for (Slab* slab = getState().slabs.load(std::memory_order_acquire); slab != nullptr; slab = slab->next) {
+				size_t liveCount = 0;
+				for (size_t word = 0; word < BITMAP_WORDS; ++word)
+					liveCount += countBits(slab->liveBits[word].load(std::memory_order_relaxed));
+				++stats.slabCount;
+				stats.liveCount += liveCount;
+				stats.liveBytes += liveCount * slab->slotSize;
+			}
+			stats.slabBytes = stats.slabCount * SLAB_SIZE;
+			return stats;
+		};
+
+	private:
+		static constexpr size_t BITMAP_WORDS	= SLAB_SIZE / SIZE_STEP / 64;
+		static constexpr size_t DIRECTORY_SIZE	= static_cast<size_t>(1) << DIRECTORY_BITS;
+
+		struct Slab {							// Header at the start of a slab
+			Slab*					next = nullptr;				// Next slab of the registry
+			uint32_t				slotSize = 0;
+			uint32_t				slotCount = 0;
+			std::atomic<uint64_t>	liveBits[BITMAP_WORDS] = {};	// One bit per live slot
+		};
+		static constexpr size_t SLOT_OFFSET		= (sizeof(Slab) + 63) & ~static_cast<size_t>(63);
+
+		struct Magazine {
+			void*	head = nullptr;				// Free slots, linked through their first word
+			size_t	count = 0;
+		};
+		struct ThreadCache {
+			Magazine	magazines[CLASS_COUNT];
+			bool		isRegistered = false;
+			bool		isClosed = false;			// The thread is exiting, slots go straight to the depot
+		};
+		struct Depot {
+#ifdef _MTP_THREADSAFETY
+			MutexObj	mutex;
+#endif // _MTP_THREADSAFETY
+			void*		freeList = nullptr;
+			Slab*		carveSlab = nullptr;		// Slab being carved into new slots
+			uint32_t	carveIndex = 0;
+		};
+		struct State {
+			Depot					depots[CLASS_COUNT];
+			std::atomic<Slab*>		slabs{ nullptr };				// Registry of all slabs
+			std::atomic<size_t>		slabCount{ 0 };
+			std::atomic<uintptr_t>	minSlab{ ~static_cast<uintptr_t>(0) };
+			std::atomic<uintptr_t>	maxSlab{ 0 };
+			std::atomic<uintptr_t>	directory[DIRECTORY_SIZE] = {};	// Open addressing set of the slab addresses
+		};
+
+		// Flushes the magazines of a thread on thread exit
+		struct CacheOwner {
+			ThreadCache* cache = nullptr;
+			~CacheOwner() {
+				if (cache == nullptr) return;
+				cache->isClosed = true;
+				for (size_t classIndex = 0; classIndex < CLASS_COUNT; ++classIndex)
+					flush(classIndex, cache->magazines[classIndex], cache->magazines[classIndex].count);
+			};
+		};
+
+		// Shared state (see NeverDestroyed)
+		_NODISCARD static State& getState(void) noexcept {
+			return NeverDestroyed<State>::get();
+		};
 
-private:
-	// Ensure trackAlloc() function run correctly
-	class AllocGuard {
+		// Get the magazines of the calling thread
+		_NODISCARD static ThreadCache& threadCache(void) noexcept {
+			thread_local ThreadCache cache;
+			if (!cache.isRegistered) {
+				cache.isRegistered = true;
+				thread_local CacheOwner owner;
+				owner.cache = &cache;
+			}
+			return cache;
+		};
+
+		// Move up to count slots from the depot into a magazine, return false if none is left
+		static bool refill(size_t classIndex, Magazine& magazine, size_t count) noexcept {
+			Depot& depot = getState().depots[classIndex];
+			const size_t slotSize = (classIndex + 1) * SIZE_STEP;
+#ifdef _MTP_THREADSAFETY
+			MutexLockGuard lock(depot.mutex);
+#endif // _MTP_THREADSAFETY
+			for (size_t moved = 0; moved < count; ++moved) {
+				void* slot = depot.freeList;
+				if (slot != nullptr) {
+					depot.freeList = *static_cast<void**>(slot);
+				}
+				else {
+					if (depot.carveSlab == nullptr || depot.carveIndex == depot.carveSlab->slotCount) {
+						depot.carveSlab = newSlab(slotSize);
+						depot.carveIndex = 0;
+						if (depot.carveSlab == nullptr) break;
+					}
+					slot = getSlotAddress(depot.carveSlab, depot.carveIndex++);
+				}
+				*static_cast<void**>(slot) = magazine.head;
+				magazine.head = slot;
+				++magazine.count;
+			}
+			return magazine.head != nullptr;
+		};
+
+		// Move count slots from a magazine back to the depot
+		static void flush(size_t classIndex, Magazine& magazine, size_t count) noexcept {
+			if (count == 0) return;
+			void* first = magazine.head;
+			void* last = first;
+			for (size_t moved = 1; moved < count; ++moved)
+				last = *static_cast<void**>(last);
+			magazine.head = *static_cast<void**>(last);
+			magazine.count -= count;
+
+			Depot& depot = getState().depots[classIndex];
+#ifdef _MTP_THREADSAFETY
+			MutexLockGuard lock(depot.mutex);
+#endif // _MTP_THREADSAFETY
+			*static_cast<void**>(last) = depot.freeList;
+			depot.freeList = first;
+		};
+
+		// Allocate and register a new slab (the caller holds the depot lock)
+		_NODISCARD static Slab* newSlab(size_t slotSize) noexcept {
+			State& state = getState();
+			if (state.slabCount.fetch_add(1, std::memory_order_relaxed) >= MAX_SLABS) {
+				state.slabCount.fetch_sub(1, std::memory_order_relaxed);
+				return nullptr;
+			}
+			void* storage = AllocatorBackend::alignedAllocate(SLAB_SIZE, SLAB_SIZE);
+			if (storage == nullptr) {
+				state.slabCount.fetch_sub(1, std::memory_order_relaxed);
+				return nullptr;
+			}
+			Slab* slab = new(storage) Slab();
+			slab->slotSize = static_cast<uint32_t>(slotSize);
+			slab->slotCount = static_cast<uint32_t>((SLAB_SIZE - SLOT_OFFSET) / slotSize);
+			addOverhead(OverheadCategory::Callsites, SLOT_OFFSET);
+
+			// Publish the slab before any of its slots is handed out
+			const uintptr_t base = reinterpret_cast<uintptr_t>(slab);
+			uintptr_t bound = state.minSlab.load(std::memory_order_relaxed);
+			while (base < bound && !state.minSlab.compare_exchange_weak(bound, base, std::memory_order_release, std::memory_order_relaxed)) {}
+			bound = state.maxSlab.load(std::memory_order_relaxed);
+			while (base > bound && !state.maxSlab.compare_exchange_weak(bound, base, std::memory_order_release, std::memory_order_relaxed)) {}
+			for (size_t idx = getDirectoryIndex(base);; idx = (idx + 1) & (DIRECTORY_SIZE - 1)) {
+				uintptr_t entry = 0;
+				if (state.directory[idx].compare_exchange_strong(entry, base, std::memory_order_release, std::memory_order_relaxed)) break;
+			}
+			Slab* head = state.slabs.load(std::memory_order_relaxed);
+			do {
+				slab->next = head;
+			} while (!state.slabs.compare_exchange_weak(head, slab, std::memory_order_release, std::memory_order_relaxed));
+			return slab;
+		};
+
+		// Find the slab of a block (nullptr if the block does not belong to a slab)
+		_NODISCARD static Slab* findSlab(const void* ptr) noexcept {
+			const uintptr_t base = reinterpret_cast<uintptr_t>(ptr) & ~static_cast<uintptr_t>(SLAB_SIZE - 1);
+			State& state = getState();
+			if (base < state.minSlab.load(std::memory_order_acquire) || base > state.maxSlab.load(std::memory_order_acquire)) return nullptr;
+			for (size_t idx = getDirectoryIndex(base);; idx = (idx + 1) & (DIRECTORY_SIZE - 1)) {
+				const uintptr_t entry = state.directory[idx].load(std::memory_order_acquire);
+				if (entry == base) return reinterpret_cast<Slab*>(base);
+				if (entry == 0) return nullptr;
+			}
+		};
+
+		// Slot helpers
+		_NODISCARD static Slab* getSlab(const void* ptr) noexcept {
+			return reinterpret_cast<Slab*>(reinterpret_cast<uintptr_t>(ptr) & ~static_cast<uintptr_t>(SLAB_SIZE - 1));
+		};
+		_NODISCARD static size_t getSlotIndex(const Slab* slab, const void* ptr) noexcept {
+			const size_t offset = static_cast<size_t>(static_cast<const char*>(ptr) - reinterpret_cast<const char*>(slab));
+			return (offset < SLOT_OFFSET) ? slab->slotCount : (offset - SLOT_OFFSET) / slab->slotSize;
+		};
+		_NODISCARD static void* getSlotAddress(Slab* slab, size_t slotIndex) noexcept {
+			return reinterpret_cast<char*>(slab) + SLOT_OFFSET + slotIndex * slab->slotSize;
+		};
+		_NODISCARD static size_t getDirectoryIndex(uintptr_t base) noexcept {
+			return static_cast<size_t>((static_cast<uint64_t>(base / SLAB_SIZE) * 0x9E3779B97F4A7C15ull) >> (64 - DIRECTORY_BITS));
+		};
+		_NODISCARD static size_t countBits(uint64_t bits) noexcept {
+			bits = bits - ((bits >> 1) & 0x5555555555555555ull);
+			bits = (bits & 0x3333333333333333ull) + ((bits >> 2) & 0x3333333333333333ull);
+			bits = (bits + (bits >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+			return static_cast<size_t>((bits * 0x0101010101010101ull) >> 56);
+		};
+	};
+#endif // _MTP_SMALL_OBJECT_ALLOCATOR
+
+	// Tracker state kept in a shared file mapping (see enablePersistentState)
+	class PersistentState {
 	public:
-		// Construction
-		AllocGuard(bool& flag) : myFlag_(flag) { myFlag_ = true; };
-		~AllocGuard() { myFlag_ = false; };
+		static constexpr uint32_t VERSION = 1;
+
+		// Destruction
+		~PersistentState() { close(); };
+
+		// Layout helpers
+		_NODISCARD static size_t mappingSize(uint32_t callsiteCapacity, uint32_t eventCapacity) noexcept {
+			return sizeof(PersistentHeader) + sizeof(PersistentCallsite) * callsiteCapacity + sizeof(PersistentEvent) * eventCapacity;
+		};
+		_NODISCARD static PersistentCallsite* callsiteTable(void* mapping) noexcept {
+			return reinterpret_cast<PersistentCallsite*>(static_cast<char*>(mapping) + sizeof(PersistentHeader));
+		};
+		_NODISCARD static const PersistentCallsite* callsiteTable(const void* mapping) noexcept {
+			return reinterpret_cast<const PersistentCallsite*>(static_cast<const char*>(mapping) + sizeof(PersistentHeader));
+		};
+		_NODISCARD static PersistentEvent* eventRing(void* mapping, uint32_t callsiteCapacity) noexcept {
+			return reinterpret_cast<PersistentEvent*>(reinterpret_cast<char*>(callsiteTable(mapping)) + sizeof(PersistentCallsite) * callsiteCapacity);
+		};
+		_NODISCARD static const PersistentEvent* eventRing(const void* mapping, uint32_t callsiteCapacity) noexcept {
+			return reinterpret_cast<const PersistentEvent*>(reinterpret_cast<const char*>(callsiteTable(mapping)) + sizeof(PersistentCallsite) * callsiteCapacity);
+		};
+
+		// Operations
+		_NODISCARD bool isOpen(void) const noexcept { return header_ != nullptr; };
+		_NODISCARD size_t getMappedSize(void) const noexcept { return mappedSize_; };
+
+		bool open(const char* path, uint32_t callsiteCapacity, uint32_t eventCapacity) {
+#ifdef _WIN32
+			(void)path; (void)callsiteCapacity; (void)eventCapacity;
+			return false;
+#else
+			if (path == nullptr) return false;
+			if (callsiteCapacity < 2) callsiteCapacity = 2;
+			const size_t size = mappingSize(callsiteCapacity, eventCapacity);
+			int fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+			if (fd < 0) return false;
+			void* mapping = MAP_FAILED;
+			if (::ftruncate(fd, static_cast<off_t>(size)) == 0)
+				mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			::close(fd);
+			if (mapping == MAP_FAILED) return false;
+
+			// The file is zero-filled, initialize the header then publish it
+			header_ = static_cast<PersistentHeader*>(mapping);
+			callsites_ = callsiteTable(mapping);
+			events_ = eventRing(mapping, callsiteCapacity);
+			mappedSize_ = size;
+			std::memcpy(header_->magic, "MTPSTATE", 8);
+			header_->version = VERSION;
+			header_->headerSize = sizeof(PersistentHeader);
+			header_->callsiteSize = sizeof(PersistentCallsite);
+			header_->callsiteCapacity = callsiteCapacity;
+			header_->eventSize = sizeof(PersistentEvent);
+			header_->eventCapacity = eventCapacity;
+			header_->processId = static_cast<uint64_t>(::getpid());
+			callsites_[0].line = -1;
+			callsites_[0].isReady.store(1, std::memory_order_release);
+			header_->callsiteCount.store(1, std::memory_order_relaxed);
+			header_->isReady.store(1, std::memory_order_release);
+			return true;
+#endif // _WIN32
+		};
+
+		void close(void) noexcept {
+#ifndef _WIN32
+			if (header_ != nullptr) ::munmap(header_, mappedSize_);
+#endif // !_WIN32
+			header_ = nullptr;
+			callsites_ = nullptr;
+			events_ = nullptr;
+			mappedSize_ = 0;
+		};
+
+		// Record an allocation (the caller holds the tracker lock)
+		void onAlloc(const void* ptr, size_t size, const DebugInfo& debugInfo, bool isEvent = true) noexcept {
+			const uint64_t liveBytes = header_->liveBytes.load(std::memory_order_relaxed) + size;
+			header_->liveCount.store(header_->liveCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			header_->liveBytes.store(liveBytes, std::memory_order_relaxed);
+			if (liveBytes > header_->peakBytes.load(std::memory_order_relaxed))
+				header_->peakBytes.store(liveBytes, std::memory_order_relaxed);
+			header_->totalAllocs.store(header_->totalAllocs.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			uint32_t slot = findCallsite(debugInfo);
+			PersistentCallsite& callsite = callsites_[slot];
+			callsite.liveCount.store(callsite.liveCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			callsite.liveBytes.store(callsite.liveBytes.load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+			callsite.totalAllocs.store(callsite.totalAllocs.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			if (isEvent) pushEvent(ptr, size, slot, false);
+		};
+
+		// Record a deallocation (the caller holds the tracker lock)
+		void onFree(const void* ptr, size_t size, const DebugInfo& debugInfo) noexcept {
+			header_->liveCount.store(header_->liveCount.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+			header_->liveBytes.store(header_->liveBytes.load(std::memory_order_relaxed) - size, std::memory_order_relaxed);
+			header_->totalFrees.store(header_->totalFrees.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			uint32_t slot = findCallsite(debugInfo);
+			PersistentCallsite& callsite = callsites_[slot];
+			callsite.liveCount.store(callsite.liveCount.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+			callsite.liveBytes.store(callsite.liveBytes.load(std::memory_order_relaxed) - size, std::memory_order_relaxed);
+			pushEvent(ptr, size, slot, true);
+		};
 
 	private:
-		bool& myFlag_;
+		// Find (or publish) the slot of a callsite, slot 0 holds unknown callsites and table overflow
+		_NODISCARD uint32_t findCallsite(const DebugInfo& debugInfo) noexcept {
+			if (debugInfo.file == nullptr) return 0;
+			const uint32_t capacity = header_->callsiteCapacity;
+			const uint64_t fileKey = reinterpret_cast<uintptr_t>(debugInfo.file);
+			uint64_t hash = (fileKey ^ (static_cast<uint64_t>(static_cast<uint32_t>(debugInfo.line)) * 0x9E3779B97F4A7C15ull)) * 0xFF51AFD7ED558CCDull;
+			uint32_t slot = static_cast<uint32_t>((hash >> 32) % (capacity - 1)) + 1;
+			for (uint32_t probe = 0; probe < capacity - 1; ++probe) {
+				PersistentCallsite& callsite = callsites_[slot];
+				if (callsite.isReady.load(std::memory_order_relaxed) == 0) {
+					// Publish a new slot, its key is written before the ready flag
+					callsite.fileKey = fileKey;
+					callsite.line = debugInfo.line;
+					std::strncpy(callsite.file, debugInfo.file, sizeof(callsite.file) - 1);
+					callsite.isReady.store(1, std::memory_order_release);
+					header_->callsiteCount.store(header_->callsiteCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+					return slot;
+				}
+				if (callsite.fileKey == fileKey && callsite.line == debugInfo.line) return slot;
+				if (++slot == capacity) slot = 1;
+			}
+			return 0;
+		};
+
+		// Write an event into the ring, its sequence number is written last
+		void pushEvent(const void* ptr, size_t size, uint32_t callsite, bool isFree) noexcept {
+			const uint32_t capacity = header_->eventCapacity;
+			if (capacity == 0) return;
+			const uint64_t seq = header_->eventCount.load(std::memory_order_relaxed);
+			PersistentEvent& event = events_[seq % capacity];
+			event.sequence.store(0, std::memory_order_relaxed);
+			std::atomic_signal_fence(std::memory_order_seq_cst);
+			event.address = reinterpret_cast<uintptr_t>(ptr);
+			event.size = size;
+			event.callsite = callsite;
+			event.isFree = isFree ? 1 : 0;
+			event.sequence.store(seq + 1, std::memory_order_release);
+			header_->eventCount.store(seq + 1, std::memory_order_release);
+		};
+
+	private:
+		PersistentHeader*	header_ = nullptr;
+		PersistentCallsite*	callsites_ = nullptr;
+		PersistentEvent*	events_ = nullptr;
+		size_t				mappedSize_ = 0;
 	};
 
 	// Debug track data wrapper (maybe dummy)
 	class DebugTracker {
 	public:
+		// Construction
+		explicit DebugTracker(std::atomic<size_t>* overheadCounters) : data_(DebugTrackData::allocator_type(overheadCounters)) {};
+
 #ifdef  _MTP_DEBUG
 		// Operations
 		void insert(const DebugTrackObj& obj) {	data_.insert(obj); };
 		void insert(Address addr, const char* file, int line) {
 			data_[addr] = { file, line };
 		};
+		void erase(Address addr) { data_.erase(addr); };
+		void reserve(size_t count) { data_.reserve(count); };
+		void clear(void) { data_.clear(); };
 		_NODISCARD const DebugInfo* get(Address addr) const {
 			auto it = data_.find(addr);
 			if (it != data_.end()) return &it->second;
@@ -434,6 +3973,9 @@ private:
 		// Dummy operations
 		void insert(const DebugTrackObj&) {};
 		void insert(Address, const char*, int) {};
+		void erase(Address) {};
+		void reserve(size_t) {};
+		void clear(void) {};
 		_NODISCARD const DebugInfo* get(Address) const { return nullptr; };
 #endif // !_MTP_DEBUG
 
@@ -442,14 +3984,731 @@ private:
 		DebugTrackData data_;
 	};
 
+#if _HAS_CXX17
+public:
+	// Report output through large aligned buffers, written to a file descriptor or an output stream
+	// Note: Two buffers are filled in turn and flushed together with a single vectored write
+	class ReportBuffer {
+	public:
+		static constexpr size_t BUFFER_SIZE		= 256 * 1024;
+		static constexpr size_t BUFFER_ALIGN	= 4096;
+
+		// Construction
+		explicit ReportBuffer(int fd) : fd_(fd) { allocateBuffers(); };
+		explicit ReportBuffer(std::ostream& os) : os_(&os) { allocateBuffers(); };
+		~ReportBuffer() {
+			for (int idx = 0; idx < 2; ++idx) {
+				if (!storage_[idx]) continue;
+				std::free(storage_[idx]);
+				subOverhead(OverheadCategory::Buffers, getHeapBlockCost(BUFFER_SIZE + BUFFER_ALIGN));
+			}
+		};
+
+		// Operations
+		void append(const char* data, size_t len) {
+			while (len != 0 && !failed_) {
+				if (used_[current_] == BUFFER_SIZE) nextBuffer();
+				size_t chunk = BUFFER_SIZE - used_[current_];
+				if (chunk > len) chunk = len;
+				std::memcpy(buffers_[current_] + used_[current_], data, chunk);
+				used_[current_] += chunk;
+				data += chunk;
+				len -= chunk;
+			}
+		};
+		void append(const char* str) { append(str, std::strlen(str)); };
+		void append(char ch) { append(&ch, 1); };
+		void appendDecimal(int64_t value) {
+			char digits[24];
+			auto result = std::to_chars(digits, digits + sizeof(digits), value);
+			append(digits, static_cast<size_t>(result.ptr - digits));
+		};
+		void appendHex(uintptr_t value) {
+			char digits[2 + sizeof(uintptr_t) * 2] = { '0', 'x' };
+			auto result = std::to_chars(digits + 2, digits + sizeof(digits), value, 16);
+			append(digits, static_cast<size_t>(result.ptr - digits));
+		};
+		void appendLittleEndian(uint64_t value, size_t bytes) {
+			char data[8];
+			for (size_t idx = 0; idx < bytes; ++idx)
+				data[idx] = static_cast<char>((value >> (idx * 8)) & 0xFF);
+			append(data, bytes);
+		};
+
+		// Write all buffered data, return false if any write failed
+		bool flush(void) {
+			if (!failed_) writeBuffers(current_ + 1);
+			return !failed_;
+		};
+
+	private:
+		// No copyable
+		ReportBuffer(const ReportBuffer&) = delete;
+		ReportBuffer& operator=(const ReportBuffer&) = delete;
+
+		// Allocate the aligned buffers
+		void allocateBuffers(void) {
+			for (int idx = 0; idx < 2; ++idx) {
+				storage_[idx] = static_cast<char*>(std::malloc(BUFFER_SIZE + BUFFER_ALIGN));
+				if (!storage_[idx]) { failed_ = true; continue; }
+				addOverhead(OverheadCategory::Buffers, getHeapBlockCost(BUFFER_SIZE + BUFFER_ALIGN));
+				uintptr_t addr = reinterpret_cast<uintptr_t>(storage_[idx]);
+				buffers_[idx] = reinterpret_cast<char*>((addr + BUFFER_ALIGN - 1) & ~(uintptr_t)(BUFFER_ALIGN - 1));
+			}
+		};
+
+		// Switch to the back buffer, flush both once they are full
+		void nextBuffer(void) {
+			if (current_ == 0) { current_ = 1; return; }
+			writeBuffers(2);
+		};
+
+		// Write the given number of buffers and reset them
+		void writeBuffers(int count) {
+			if (os_ != nullptr) {
+				for (int idx = 0; idx < count; ++idx)
+					os_->write(buffers_[idx], static_cast<std::streamsize>(used_[idx]));
+				if (!os_->good()) failed_ = true;
+			}
+			else {
+#ifdef _WIN32
+				for (int idx = 0; idx < count && !failed_; ++idx) {
+					const char* data = buffers_[idx];
+					size_t remain = used_[idx];
+					while (remain != 0) {
+						int written = _write(fd_, data, static_cast<unsigned int>(remain));
+						if (written <= 0) { failed_ = true; break; }
+						data += written;
+						remain -= static_cast<size_t>(written);
+					}
+				}
+#else
+				struct iovec iov[2];
+				int iovCount = 0;
+				for (int idx = 0; idx < count; ++idx)
+					if (used_[idx] != 0) iov[iovCount++] = { buffers_[idx], used_[idx] };
+				while (iovCount != 0) {
+					ssize_t written = ::pwritev(fd_, iov, iovCount, static_cast<off_t>(offset_));
+					if (written < 0 && errno == EINTR) continue;
+					if (written <= 0) { failed_ = true; break; }
+					offset_ += static_cast<uint64_t>(written);
+					// Skip the fully written vectors, advance into a partially written one
+					size_t done = static_cast<size_t>(written);
+					while (iovCount != 0 && done >= iov[0].iov_len) {
+						done -= iov[0].iov_len;
+						iov[0] = iov[1];
+						--iovCount;
+					}
+					if (iovCount != 0) {
+						iov[0].iov_base = static_cast<char*>(iov[0].iov_base) + done;
+						iov[0].iov_len -= done;
+					}
+				}
+#endif // _WIN32
+			}
+			used_[0] = used_[1] = 0;
+			current_ = 0;
+		};
+
+	private:
+		int				fd_ = -1;
+		std::ostream*	os_ = nullptr;
+		char*			storage_[2] = { nullptr, nullptr };	// Raw (unaligned) buffer storage
+		char*			buffers_[2] = { nullptr, nullptr };	// Aligned buffers
+		size_t			used_[2] = { 0, 0 };
+		int				current_ = 0;
+		uint64_t		offset_ = 0;
+		bool			failed_ = false;
+	};
+
+	// Built-in report formats
+	enum class ReportFormat {
+		Text,								// Human readable sentences (same as printTrackingReport)
+		JsonLines,							// One JSON object per allocation record
+		Csv,								// Comma-separated values with a header row
+		Binary,								// Compact little-endian records with a header and a file name table
+	};
+
+	// Kinds of the groups of aggregated live blocks in a report
+	enum class ReportGroupKind {
+		SmallBlocks = 1,					// Small blocks counted per callsite (see setSmallBlockThreshold)
+		SmallObjects = 2,					// Small objects of the small object allocator, per slot size
+	};
+
+	// Report formatter interface, implement it to plug in a custom report format
+	class ReportFormatter {
+	public:
+		virtual ~ReportFormatter() = default;
+
+		// Called once before the records, with the number of records that follow
+		virtual void begin(ReportBuffer& /*buffer*/, size_t /*recordCount*/) {};
+		// Called once per live allocation record
+		virtual void record(ReportBuffer& buffer, const AllocRecord& record) = 0;
+		// Called once per group of aggregated live blocks, after the records
+		virtual void group(ReportBuffer& /*buffer*/, const LeakGroup& /*group*/, ReportGroupKind /*kind*/) {};
+		// Called once per live object of a registered pool, after the groups
+		virtual void poolObject(ReportBuffer& /*buffer*/, const PoolObject& /*object*/) {};
+		// Called once after the pool objects if the tracker memory limit was reached
+		virtual void overflow(ReportBuffer& /*buffer*/, const OverflowSummary& /*summary*/) {};
+		// Called once at the end of the report
+		virtual void end(ReportBuffer& /*buffer*/) {};
+	};
+
+	// Human readable report ("Leaked: N bytes at 0x...")
+	class TextReportFormatter : public ReportFormatter {
+	public:
+		void record(ReportBuffer& buffer, const AllocRecord& record) override {
+			beginLeaks(buffer);
+			buffer.append("Leaked: ");
+			buffer.appendDecimal(static_cast<int64_t>(record.size));
+			buffer.append(record.isArray ? " bytes of an array at " : " bytes at ");
+			buffer.appendHex(reinterpret_cast<uintptr_t>(record.address));
+#ifdef _MTP_DEBUG
+			if (record.callsite.file != nullptr || record.callsite.line != -1) {
+				buffer.append(" in ");
+				buffer.append((record.callsite.file != nullptr) ? record.callsite.file : "unknown file");
+				if (record.callsite.line != -1) {
+					buffer.append(" (line:");
+					buffer.appendDecimal(record.callsite.line);
+					buffer.append(')');
+				}
+				else
+					buffer.append(" (line: unknown)");
+			}
+#endif // _MTP_DEBUG
+			buffer.append(".\n");
+		};
+		void group(ReportBuffer& buffer, const LeakGroup& group, ReportGroupKind kind) override {
+			beginLeaks(buffer);
+			buffer.append("Leaked: ");
+			buffer.appendDecimal(static_cast<int64_t>(group.bytes));
+			buffer.append(" bytes in ");
+			buffer.appendDecimal(static_cast<int64_t>(group.count));
+			buffer.append((kind == ReportGroupKind::SmallObjects) ? " small objects of up to " : " aggregated blocks of up to ");
+			buffer.appendDecimal(static_cast<int64_t>(group.blockSize));
+			buffer.append(" bytes");
+#ifdef _MTP_DEBUG
+			if (kind == ReportGroupKind::SmallBlocks) {
+				buffer.append(" in ");
+				buffer.append((group.callsite.file != nullptr) ? group.callsite.file : "unknown file");
+				if (group.callsite.line != -1) {
+					buffer.append(" (line:");
+					buffer.appendDecimal(group.callsite.line);
+					buffer.append(')');
+				}
+				else
+					buffer.append(" (line: unknown)");
+			}
+#endif // _MTP_DEBUG
+			buffer.append(".\n");
+		};
+		void poolObject(ReportBuffer& buffer, const PoolObject& object) override {
+			beginLeaks(buffer);
+			buffer.append("Leaked: ");
+			buffer.appendDecimal(static_cast<int64_t>(object.size));
+			buffer.append(" bytes at ");
+			buffer.appendHex(reinterpret_cast<uintptr_t>(object.address));
+			buffer.append(" (");
+			buffer.append((object.pool != nullptr) ? object.pool : "unknown");
+			buffer.append(" pool object).\n");
+		};
+		void overflow(ReportBuffer& buffer, const OverflowSummary& summary) override {
+			// Same as printTrackingReport: only reported along with the leaks
+			if (!hasLeaks_) return;
+			buffer.append("Tracker memory limit reached: ");
+			buffer.appendDecimal(static_cast<int64_t>(summary.liveCount));
+			buffer.append(" live blocks (");
+			buffer.appendDecimal(static_cast<int64_t>(summary.liveBytes));
+			buffer.append(" bytes) are summarized, ");
+			buffer.appendDecimal(static_cast<int64_t>(summary.totalCount));
+			buffer.append(" blocks (");
+			buffer.appendDecimal(static_cast<int64_t>(summary.totalBytes));
+			buffer.append(" bytes) in total.\n");
+		};
+		void end(ReportBuffer& buffer) override {
+			if (!hasLeaks_) buffer.append("\nNo memory leaks detected.\n");
+		};
+
+	private:
+		// Print the leaks banner before the first leak
+		void beginLeaks(ReportBuffer& buffer) {
+			if (hasLeaks_) return;
+			buffer.append("\n--- Memory Leaks Detected ---\n");
+			hasLeaks_ = true;
+		};
+
+	private:
+		bool	hasLeaks_ = false;
+	};
+
+	// JSON Lines report ({"address":"0x...","size":N,"isArray":false,"file":"...","line":N})
+	// Note: Groups, pool objects and the overflow summary are reported as
+	//		 {"group":"smallBlocks|smallObjects","blockSize":N,"count":N,"bytes":N,"file":"...","line":N},
+	//		 {"address":"0x...","size":N,"pool":"..."} and {"overflow":{"liveCount":N,"liveBytes":N,"totalCount":N,"totalBytes":N}}
+	class JsonLinesReportFormatter : public ReportFormatter {
+	public:
+		void record(ReportBuffer& buffer, const AllocRecord& record) override {
+			buffer.append("{\"address\":\"");
+			buffer.appendHex(reinterpret_cast<uintptr_t>(record.address));
+			buffer.append("\",\"size\":");
+			buffer.appendDecimal(static_cast<int64_t>(record.size));
+			buffer.append(record.isArray ? ",\"isArray\":true,\"file\":" : ",\"isArray\":false,\"file\":");
+			appendString(buffer, record.callsite.file);
+			buffer.append(",\"line\":");
+			buffer.appendDecimal(record.callsite.line);
+			buffer.append("}\n");
+		};
+		void group(ReportBuffer& buffer, const LeakGroup& group, ReportGroupKind kind) override {
+			buffer.append((kind == ReportGroupKind::SmallObjects) ? "{\"group\":\"smallObjects\",\"blockSize\":" : "{\"group\":\"smallBlocks\",\"blockSize\":");
+			buffer.appendDecimal(static_cast<int64_t>(group.blockSize));
+			buffer.append(",\"count\":");
+			buffer.appendDecimal(static_cast<int64_t>(group.count));
+			buffer.append(",\"bytes\":");
+			buffer.appendDecimal(static_cast<int64_t>(group.bytes));
+			buffer.append(",\"file\":");
+			appendString(buffer, group.callsite.file);
+			buffer.append(",\"line\":");
+			buffer.appendDecimal(group.callsite.line);
+			buffer.append("}\n");
+		};
+		void poolObject(ReportBuffer& buffer, const PoolObject& object) override {
+			buffer.append("{\"address\":\"");
+			buffer.appendHex(reinterpret_cast<uintptr_t>(object.address));
+			buffer.append("\",\"size\":");
+			buffer.appendDecimal(static_cast<int64_t>(object.size));
+			buffer.append(",\"pool\":");
+			appendString(buffer, object.pool);
+			buffer.append("}\n");
+		};
+		void overflow(ReportBuffer& buffer, const OverflowSummary& summary) override {
+			buffer.append("{\"overflow\":{\"liveCount\":");
+			buffer.appendDecimal(static_cast<int64_t>(summary.liveCount));
+			buffer.append(",\"liveBytes\":");
+			buffer.appendDecimal(static_cast<int64_t>(summary.liveBytes));
+			buffer.append(",\"totalCount\":");
+			buffer.appendDecimal(static_cast<int64_t>(summary.totalCount));
+			buffer.append(",\"totalBytes\":");
+			buffer.appendDecimal(static_cast<int64_t>(summary.totalBytes));
+			buffer.append("}}\n");
+		};
+
+	private:
+		// Append a quoted and escaped string, or null
+		static void appendString(ReportBuffer& buffer, const char* str) {
+			if (str == nullptr) {
+				buffer.append("null");
+				return;
+			}
+			buffer.append('"');
+			for (const char* ch = str; *ch != '\0'; ++ch) {
+				if (*ch == '"' || *ch == '\\') buffer.append('\\');
+				if (static_cast<unsigned char>(*ch) < 0x20) continue;	// Drop control characters
+				buffer.append(*ch);
+			}
+			buffer.append('"');
+		};
+	};
+
+	// CSV report (address,size,is_array,file,line,kind,count,block_size)
+	// Note: The kind is block, small_blocks, small_objects, pool (the file is the pool name),
+	//		 overflow_live or overflow_total (the size and count of the summarized blocks)
+	class CsvReportFormatter : public ReportFormatter {
+	public:
+		void begin(ReportBuffer& buffer, size_t) override {
+			buffer.append("address,size,is_array,file,line,kind,count,block_size\n");
+		};
+		void record(ReportBuffer& buffer, const AllocRecord& record) override {
+			buffer.appendHex(reinterpret_cast<uintptr_t>(record.address));
+			buffer.append(',');
+			buffer.appendDecimal(static_cast<int64_t>(record.size));
+			buffer.append(record.isArray ? ",1," : ",0,");
+			appendString(buffer, record.callsite.file);
+			buffer.append(',');
+			buffer.appendDecimal(record.callsite.line);
+			buffer.append(",block,1,");
+			buffer.appendDecimal(static_cast<int64_t>(record.size));
+			buffer.append('\n');
+		};
+		void group(ReportBuffer& buffer, const LeakGroup& group, ReportGroupKind kind) override {
+			buffer.append(',');
+			buffer.appendDecimal(static_cast<int64_t>(group.bytes));
+			buffer.append(",0,");
+			appendString(buffer, group.callsite.file);
+			buffer.append(',');
+			buffer.appendDecimal(group.callsite.line);
+			buffer.append((kind == ReportGroupKind::SmallObjects) ? ",small_objects," : ",small_blocks,");
+			buffer.appendDecimal(static_cast<int64_t>(group.count));
+			buffer.append(',');
+			buffer.appendDecimal(static_cast<int64_t>(group.blockSize));
+			buffer.append('\n');
+		};
+		void poolObject(ReportBuffer& buffer, const PoolObject& object) override {
+			buffer.appendHex(reinterpret_cast<uintptr_t>(object.address));
+			buffer.append(',');
+			buffer.appendDecimal(static_cast<int64_t>(object.size));
+			buffer.append(",0,");
+			appendString(buffer, object.pool);
+			buffer.append(",-1,pool,1,");
+			buffer.appendDecimal(static_cast<int64_t>(object.size));
+			buffer.append('\n');
+		};
+		void overflow(ReportBuffer& buffer, const OverflowSummary& summary) override {
+			buffer.append(',');
+			buffer.appendDecimal(static_cast<int64_t>(summary.liveBytes));
+			buffer.append(",0,,-1,overflow_live,");
+			buffer.appendDecimal(static_cast<int64_t>(summary.liveCount));
+			buffer.append(",\n,");
+			buffer.appendDecimal(static_cast<int64_t>(summary.totalBytes));
+			buffer.append(",0,,-1,overflow_total,");
+			buffer.appendDecimal(static_cast<int64_t>(summary.totalCount));
+			buffer.append(",\n");
+		};
+
+	private:
+		// Append a quoted string (nothing if null)
+		static void appendString(ReportBuffer& buffer, const char* str) {
+			if (str == nullptr) return;
+			buffer.append('"');
+			for (const char* ch = str; *ch != '\0'; ++ch) {
+				if (*ch == '"') buffer.append('"');
+				buffer.append(*ch);
+			}
+			buffer.append('"');
+		};
+	};
+
+	// Compact binary report, all integers are little-endian:
+	//   header:	"MTPR" magic, u16 version (2), u16 header size (24), u32 record size (24), u32 reserved, u64 record count
+	//   records:	u64 address, u64 size (top bit set for arrays), u32 file index (0 = unknown), i32 line
+	//   entries:	u32 tag, then per tag:
+	//				1 (group):		u32 kind (ReportGroupKind), u32 file index, i32 line, u64 block size, u64 count, u64 bytes
+	//				2 (pool object):	u64 address, u64 size, u32 pool name index (in the file table)
+	//				3 (overflow):		u64 live count, u64 live bytes, u64 total count, u64 total bytes
+	//				0 (end of the entries)
+	//   files:		u32 file count, then per file (index 1..count): u32 length, name bytes
+	class BinaryReportFormatter : public ReportFormatter {
+	public:
+		static constexpr uint16_t FORMAT_VERSION	= 2;
+		static constexpr uint16_t HEADER_SIZE		= 24;
+		static constexpr uint32_t RECORD_SIZE		= 24;
+
+		void begin(ReportBuffer& buffer, size_t recordCount) override {
+			buffer.append("MTPR", 4);
+			buffer.appendLittleEndian(FORMAT_VERSION, 2);
+			buffer.appendLittleEndian(HEADER_SIZE, 2);
+			buffer.appendLittleEndian(RECORD_SIZE, 4);
+			buffer.appendLittleEndian(0, 4);
+			buffer.appendLittleEndian(recordCount, 8);
+		};
+		void record(ReportBuffer& buffer, const AllocRecord& record) override {
+			uint64_t size = static_cast<uint64_t>(record.size) & ~(1ull << 63);
+			if (record.isArray) size |= (1ull << 63);
+			buffer.appendLittleEndian(reinterpret_cast<uintptr_t>(record.address), 8);
+			buffer.appendLittleEndian(size, 8);
+			buffer.appendLittleEndian(fileIndex(record.callsite.file), 4);
+			buffer.appendLittleEndian(static_cast<uint32_t>(record.callsite.line), 4);
+		};
+		void group(ReportBuffer& buffer, const LeakGroup& group, ReportGroupKind kind) override {
+			buffer.appendLittleEndian(1, 4);
+			buffer.appendLittleEndian(static_cast<uint32_t>(kind), 4);
+			buffer.appendLittleEndian(fileIndex(group.callsite.file), 4);
+			buffer.appendLittleEndian(static_cast<uint32_t>(group.callsite.line), 4);
+			buffer.appendLittleEndian(group.blockSize, 8);
+			buffer.appendLittleEndian(group.count, 8);
+			buffer.appendLittleEndian(group.bytes, 8);
+		};
+		void poolObject(ReportBuffer& buffer, const PoolObject& object) override {
+			buffer.appendLittleEndian(2, 4);
+			buffer.appendLittleEndian(reinterpret_cast<uintptr_t>(object.address), 8);
+			buffer.appendLittleEndian(object.size, 8);
+			buffer.appendLittleEndian(fileIndex(object.pool), 4);
+		};
+		void overflow(ReportBuffer& buffer, const OverflowSummary& summary) override {
+			buffer.appendLittleEndian(3, 4);
+			buffer.appendLittleEndian(summary.liveCount, 8);
+			buffer.appendLittleEndian(summary.liveBytes, 8);
+			buffer.appendLittleEndian(summary.totalCount, 8);
+			buffer.appendLittleEndian(summary.totalBytes, 8);
+		};
+		void end(ReportBuffer& buffer) override {
+			buffer.appendLittleEndian(0, 4);
+			buffer.appendLittleEndian(files_.size(), 4);
+			for (const char* file : files_) {
+				size_t len = std::strlen(file);
+				buffer.appendLittleEndian(len, 4);
+				buffer.append(file, len);
+			}
+		};
+
+	private:
+		using FileIndexData = typename std::unordered_map<const char*, uint32_t, std::hash<const char*>, std::equal_to<const char*>,
+														  InternalAllocator<std::pair<const char* const, uint32_t>>>;
+
+		// Get the table index of a file or pool name (names are literals, compared by address)
+		uint32_t fileIndex(const char* file) {
+			if (file == nullptr) return 0;
+			auto it = fileIndices_.find(file);
+			if (it != fileIndices_.end()) return it->second;
+			files_.push_back(file);
+			uint32_t index = static_cast<uint32_t>(files_.size());
+			fileIndices_.emplace(file, index);
+			return index;
+		};
+
+	private:
+		FileIndexData											fileIndices_;
+		std::vector<const char*, InternalAllocator<const char*>>	files_;
+	};
+
+	// Format live allocation records through a formatter, as of a pinned epoch, followed by the same
+	// small block groups, small objects, pool objects and overflow summary as printTrackingReport
+	void formatTrackingReport(ReportFormatter& formatter, ReportBuffer& buffer) const {
+		const ReportExtras extras = getReportExtras();
+		{
+			const EpochPin pin(*this);
+			formatter.begin(buffer, allocTrackData_.size());
+			forEachLive([&](const AllocRecord& record) { formatter.record(buffer, record); });
+		}
+		formatReportExtras(formatter, buffer, extras);
+		formatter.end(buffer);
+	};
+
+	// Print memory tracking report data through a formatter (to file/console, ...)
+	void printTrackingReport(std::ostream& os, ReportFormatter& formatter) const {
+		ReportBuffer buffer(os);
+		formatTrackingReport(formatter, buffer);
+		buffer.flush();
+	};
+
+	// Print memory tracking report data in a built-in format (to file/console, ...)
+	void printTrackingReport(std::ostream& os, ReportFormat format) const {
+		ReportFormatterSlot slot(format);
+		printTrackingReport(os, slot.get());
+	};
+
+	// Write memory tracking report data in a built-in format into a file, return true on success
+	_NODISCARD bool writeTrackingReport(const char* path, ReportFormat format = ReportFormat::Text) const {
+		int fd = openReportFile(path);
+		if (fd < 0) return false;
+		bool isWritten = false;
+		{
+			ReportFormatterSlot slot(format);
+			ReportBuffer buffer(fd);
+			formatTrackingReport(slot.get(), buffer);
+			isWritten = buffer.flush();
+		}
+		closeReportFile(fd);
+		return isWritten;
+	};
+
+#ifdef _MTP_THREADSAFETY
+	// Print memory tracking report data to a file on a dedicated writer thread (the caller only takes a snapshot)
+	// The returned future becomes ready with true once the whole report is written to the file
+	_NODISCARD std::future<bool> printTrackingReportAsync(const char* path, ReportFormat format = ReportFormat::Text) {
+		ReportExtras extras = getReportExtras();
+		return asyncReportWriter_.submit(path, format, takeSnapshot(), std::move(extras));
+	};
+#endif // _MTP_THREADSAFETY
+
+private:
+	// Holds one of the built-in formatters without a heap allocation
+	class ReportFormatterSlot {
+	public:
+		// Construction
+		explicit ReportFormatterSlot(ReportFormat format) {
+			switch (format) {
+			case ReportFormat::JsonLines:	formatter_ = new(&storage_) JsonLinesReportFormatter();	break;
+			case ReportFormat::Csv:			formatter_ = new(&storage_) CsvReportFormatter();		break;
+			case ReportFormat::Binary:		formatter_ = new(&storage_) BinaryReportFormatter();	break;
+			default:						formatter_ = new(&storage_) TextReportFormatter();		break;
+			}
+		};
+		~ReportFormatterSlot() { formatter_->~ReportFormatter(); };
+
+		// Operations
+		_NODISCARD ReportFormatter& get(void) noexcept { return *formatter_; };
+
+	private:
+		// No copyable
+		ReportFormatterSlot(const ReportFormatterSlot&) = delete;
+		ReportFormatterSlot& operator=(const ReportFormatterSlot&) = delete;
+
+	private:
+		alignas(BinaryReportFormatter) unsigned char	storage_[sizeof(BinaryReportFormatter)];
+		ReportFormatter*								formatter_ = nullptr;
+	};
+
+	// Open a report file for writing (truncated), return -1 on failure
+	_NODISCARD static int openReportFile(const char* path) noexcept {
+#ifdef _WIN32
+		return _open(path, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+		return ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+#endif // _WIN32
+	};
+
+	// Close a report file
+	static void closeReportFile(int fd) noexcept {
+#ifdef _WIN32
+		_close(fd);
+#else
+		::close(fd);
+#endif // _WIN32
+	};
+
+	// Format the live blocks reported beside the tracking table records (between the records and the end)
+	static void formatReportExtras(ReportFormatter& formatter, ReportBuffer& buffer, const ReportExtras& extras) {
+		for (const auto& group : extras.smallBlocks)
+			formatter.group(buffer, group, ReportGroupKind::SmallBlocks);
+		for (const auto& group : extras.smallObjects)
+			formatter.group(buffer, group, ReportGroupKind::SmallObjects);
+		for (const auto& object : extras.poolObjects)
+			formatter.poolObject(buffer, object);
+		if (extras.overflow.totalCount != 0) formatter.overflow(buffer, extras.overflow);
+	};
+
+	// Write a whole tracking report of a snapshot into a file, return true on success
+	_NODISCARD static bool writeSnapshotReport(const char* path, const AllocSnapshot& snapshot, const ReportExtras& extras, ReportFormat format) {
+		int fd = openReportFile(path);
+		if (fd < 0) return false;
+		bool isWritten = false;
+		{
+			ReportFormatterSlot slot(format);
+			ReportBuffer buffer(fd);
+			slot.get().begin(buffer, snapshot.size());
+			for (const auto& record : snapshot)
+				slot.get().record(buffer, record);
+			formatReportExtras(slot.get(), buffer, extras);
+			slot.get().end(buffer);
+			isWritten = buffer.flush();
+		}
+		closeReportFile(fd);
+		return isWritten;
+	};
+#endif // _HAS_CXX17
+
+#ifdef _MTP_THREADSAFETY
+	// Dedicated writer thread for asynchronous reports (started on first use)
+	class AsyncReportWriter {
+	public:
+		// Destruction
+		~AsyncReportWriter() { stop(); };
+
+		// Queue a snapshot to be written into a file
+		_NODISCARD std::future<bool> submit(const char* path, ReportFormat format, AllocSnapshot&& snapshot, ReportExtras&& extras) {
+			ReportJob job;
+			job.path = (path != nullptr) ? path : "";
+			job.format = format;
+			job.snapshot = std::move(snapshot);
+			job.extras = std::move(extras);
+			std::future<bool> result = job.promise.get_future();
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				if (isStopped_) {
+					job.promise.set_value(false);
+					return result;
+				}
+				jobs_.push_back(std::move(job));
+				if (!thread_.joinable())
+					thread_ = std::thread(&AsyncReportWriter::run, this);
+			}
+			condition_.notify_one();
+			return result;
+		};
+
+		// Write the queued reports and stop the writer thread
+		void stop(void) {
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				isStopped_ = true;
+			}
+			condition_.notify_one();
+			if (thread_.joinable() && thread_.get_id() != std::this_thread::get_id())
+				thread_.join();
+		};
+
+	private:
+		struct ReportJob {						// Struct to hold a pending report
+			StringData			path;
+			ReportFormat		format = ReportFormat::Text;
+			AllocSnapshot		snapshot;
+			ReportExtras		extras;
+			std::promise<bool>	promise;
+		};
+
+		// Writer thread loop
+		void run(void) {
+			std::unique_lock<std::mutex> lock(mutex_);
+			while (true) {
+				condition_.wait(lock, [this] { return isStopped_ || !jobs_.empty(); });
+				if (jobs_.empty()) break;
+				ReportJob job = std::move(jobs_.front());
+				jobs_.pop_front();
+				lock.unlock();
+				bool isWritten = false;
+				try { isWritten = writeSnapshotReport(job.path.c_str(), job.snapshot, job.extras, job.format); }
+				catch (...) { isWritten = false; }
+				job.promise.set_value(isWritten);
+				lock.lock();
+			}
+		};
+
+	private:
+		std::mutex					mutex_;
+		std::condition_variable		condition_;
+		std::deque<ReportJob>		jobs_;
+		std::thread					thread_;
+		bool						isStopped_ = false;
+	};
+#endif // _MTP_THREADSAFETY
+
 private:
 	// Attributes
-	AllocTrackData		allocTrackData_;				// Stores all allocation info
-	DebugTracker		debugTrackData_;				// Stores all debug tracking info
+	// Note: The tracking tables are mutable so that the last epoch reader can fold in the deferred changes
+	std::atomic<size_t>	overheadBytes_[OVERHEAD_CATEGORY_COUNT] = {};	// Bytes of the heap blocks of the tables per category
+	mutable AllocTrackData	allocTrackData_;			// Stores all allocation info
+	mutable DebugTracker	debugTrackData_;			// Stores all debug tracking info
+	mutable EpochDeltaData	epochDelta_;				// Stores the tracking changes deferred by a pinned epoch
+	mutable size_t		epochReaders_ = 0;				// Number of readers pinning the current epoch
+	mutable bool		isTableCollected_ = false;		// Check if the table pinned by readers only holds collected blocks
+	mutable uint64_t	epoch_ = 0;						// Current tracking epoch
+	size_t				liveCount_ = 0;					// Number of live tracked memory blocks
+	size_t				liveBytes_ = 0;					// Total size of live tracked memory blocks (in bytes)
+	SmallBlockTable		smallBlocks_;					// Counters of the live small blocks
+	std::atomic<size_t>	smallBlockThreshold_{ 0 };		// Blocks under this size are only counted per callsite
+	SmallBlockSet		smallBlockSet_;					// Addresses of the live small blocks
+	OverflowSlabs		overflowSlabs_;					// Blocks counted per callsite once the tracker memory limit is reached
+	size_t				peakLiveCount_ = 0;				// Peak number of blocks in the tracking table
+	size_t				peakSmallCount_ = 0;			// Peak number of blocks counted per callsite
+	uint64_t			sizeClassCounts_[SIZE_CLASS_COUNT] = {};	// Number of allocations per power of two size class
+	StartupProfile		startupProfile_;				// Allocation profile of the previous run
+	std::atomic<uint64_t>	sampledOperations_{ 0 };	// Number of timed tracking operations
+	std::atomic<uint64_t>	sampledNanoseconds_{ 0 };	// Time spent in the timed tracking operations
+	size_t				trackerMemoryLimit_ = 0;		// Tracking table memory cap (0: unlimited)
+	AtomicFlag			isTableFull_ = false;			// Check if the per-address memory reached the tracker memory limit
+	OverflowSummary		overflowSummary_;				// Blocks summarized because of the memory cap
+	PersistentState		persistentState_;				// Persistent tracker state (shared file mapping)
+	RuntimeOptions		runtimeOptions_;				// Options parsed from MTP_OPTIONS
+	std::atomic<HookList*>	allocHooks_{ nullptr };		// Published allocation hooks
+	std::atomic<HookList*>	freeHooks_{ nullptr };		// Published deallocation hooks
+	HookList*			retiredHooks_ = nullptr;		// Replaced hook lists, released with the tracker
+	HookId				lastHookId_ = 0;				// Id of the last added hook
+	std::atomic<uintptr_t>	trackedRangeBegin_{ ~uintptr_t(0) };	// Lowest address of the live tracked blocks
+	std::atomic<uintptr_t>	trackedRangeEnd_{ 0 };		// End of the highest live tracked block
+	TrackedFilter		trackedFilter_;					// Rules out most untracked blocks on free, without the lock
+#ifdef _MTP_GROWTH_TRACKING
+	GrowthTracker		growthTracker_;					// Reallocation chains of the tracked blocks
+#endif // _MTP_GROWTH_TRACKING
+	AtomicFlag			isTrackingEnabled_ = false;		// Check if new allocations are tracked
+	AtomicFlag			isShutdown_ = false;			// Check if the termination reports and garbage collection ran
+	bool				isCollected_ = false;			// Check if the garbage collection has run (untracked frees are ignored)
+	mutable AtomicFlag	isTableMutating_ = false;		// Check if the tracking table is being modified (for signal dumps)
+	mutable AtomicFlag	isDumpingTable_ = false;		// Check if a signal dump is walking the tracking table
 	AtomicFlag			isTrackerInitialized_ = false;	// Check if the tracker finished initializing
 	mutable AtomicFlag	isInReporting_ = false;			// Check if the tracking report process is running
 #ifdef _MTP_THREADSAFETY
 	mutable MutexObj	myMutex_;						// Ensures thread-safety
+	AsyncReportWriter	asyncReportWriter_;				// Writes asynchronous reports
 #endif // _MTP_THREADSAFETY
 };
 
@@ -458,20 +4717,76 @@ private:
 // Declare global tracker to handle memory allocation tracking and leak detection
 // ================================================================================
 
-class GlobalMemTracker final /* non-inheritable */ {
-	// To prevent from directly accessing
-#if _HAS_CXX17
-	static inline MemTrackifyPlus globalTracker_;
-#else
-	static MemTrackifyPlus globalTracker_;
-#endif
-	virtual void dummyFunc() = 0; /* non-instantiable */
-public:
-	_NODISCARD static MemTrackifyPlus* get(void) {
-		return &globalTracker_;
+class GlobalMemTracker final /* non-inheritable */ {
+	// Global tracker states
+	enum : int {
+		TRACKER_UNINITIALIZED = 0,			// Nothing constructed yet (the constant-initialized state)
+		TRACKER_INITIALIZING,				// Being constructed by the first tracked allocation
+		TRACKER_READY,						// Constructed (and never destroyed, see GlobalMemTracker::ExitGuard)
+	};
+
+	// To prevent from directly accessing
+	// Note: The tracker lives in raw static storage, which is constant-initialized, so no constructor runs during
+	//		 static initialization. It is constructed on first use, with no heap work before that.
+#if _HAS_CXX17
+	alignas(MemTrackifyPlus) static inline unsigned char trackerStorage_[sizeof(MemTrackifyPlus)];
+	_MTP_CONSTINIT static inline std::atomic<int> trackerState_{ TRACKER_UNINITIALIZED };
+	_MTP_CONSTINIT static inline std::atomic<size_t> exitGuardCount_{ 0 };
+#else
+	alignas(MemTrackifyPlus) static unsigned char trackerStorage_[sizeof(MemTrackifyPlus)];
+	static std::atomic<int> trackerState_;
+	static std::atomic<size_t> exitGuardCount_;
+#endif
+	virtual void dummyFunc() = 0; /* non-instantiable */
+public:
+	_NODISCARD static MemTrackifyPlus* get(void) {
+		if (trackerState_.load(std::memory_order_acquire) == TRACKER_READY) return tracker();
+		return initialize();
+	};
+
+	// Get the tracker without constructing it (usable in signal handlers), nullptr if not constructed yet
+	_NODISCARD static MemTrackifyPlus* getIfReady(void) noexcept {
+		return (trackerState_.load(std::memory_order_acquire) == TRACKER_READY) ? tracker() : nullptr;
+	};
+
+	// Exit work guard, one per translation unit including this header (nifty counter)
+	// Note: The first guard is constructed during the static initialization, before the static objects defined
+	//		 after the include, so the last one is destroyed after all of them: the termination reports and
+	//		 garbage collection run then, whenever the tracker was constructed. No allocation, no tracker construction.
+	class ExitGuard {
+	public:
+		ExitGuard() noexcept { exitGuardCount_.fetch_add(1, std::memory_order_relaxed); };
+		~ExitGuard() {
+			if (exitGuardCount_.fetch_sub(1, std::memory_order_acq_rel) == 1 && getIfReady() != nullptr)
+				tracker()->shutdown();
+		};
+
+	private:
+		// No copyable
+		ExitGuard(const ExitGuard&) = delete;
+		ExitGuard& operator=(const ExitGuard&) = delete;
+	};
+
+private:
+	_NODISCARD static MemTrackifyPlus* tracker(void) noexcept {
+		return reinterpret_cast<MemTrackifyPlus*>(trackerStorage_);
+	};
+
+	// Construct the tracker on first use
+	// Note: Allocations made while it is being constructed (by any thread) get nullptr and stay untracked
+	static MemTrackifyPlus* initialize(void) {
+		int state = TRACKER_UNINITIALIZED;
+		if (!trackerState_.compare_exchange_strong(state, TRACKER_INITIALIZING, std::memory_order_acq_rel))
+			return (state == TRACKER_READY) ? tracker() : nullptr;
+		new(trackerStorage_) MemTrackifyPlus();
+		trackerState_.store(TRACKER_READY, std::memory_order_release);
+		return tracker();
 	};
 };
 
+// Exit work guard of this translation unit (see GlobalMemTracker::ExitGuard)
+static GlobalMemTracker::ExitGuard mtpExitGuard_;
+
 // Access the global Memory Tracker
 _NODISCARD inline MemTrackifyPlus* getGlobalMemTracker(void) {
 	return GlobalMemTracker::get();
@@ -486,25 +4801,109 @@ _NODISCARD inline MemTrackifyPlus* getGlobalMemTracker(void) {
 #ifndef _MTP_DEBUG
 inline void* MemTrackifyPlus::smartAlloc(size_t size, bool isArray) {
 	MemTrackifyPlus* allocTracker = getGlobalMemTracker();
-	if (allocTracker) return allocTracker->reqTrackAlloc(size, "unknown", -1, isArray);
-	return std::malloc(size);
+	if (allocTracker && allocTracker->isTrackingEnabled_.load(std::memory_order_relaxed))
+		return allocTracker->reqTrackAlloc(size, "unknown", -1, isArray);
+	return AllocatorBackend::allocate(size);
 };
 #else
 inline void* MemTrackifyPlus::smartAlloc(size_t size, const char* file, int line, bool isArray) {
 	MemTrackifyPlus* allocTracker = getGlobalMemTracker();
-	if (allocTracker) return allocTracker->reqTrackAlloc(size, file, line, isArray);
-	return std::malloc(size);
+	if (allocTracker && allocTracker->isTrackingEnabled_.load(std::memory_order_relaxed))
+		return allocTracker->reqTrackAlloc(size, file, line, isArray);
+	return AllocatorBackend::allocate(size);
+};
+
+// Caller name, interned so that each caller keeps a single name pointer (the callsites are compared by pointer)
+// Note: Lock-free and allocation-free, the callers beyond the table capacity are "unknown" (never chained)
+inline const char* MemTrackifyPlus::getCallerName(const void* caller) noexcept {
+	constexpr size_t CAPACITY = 2048;
+	constexpr size_t MAX_PROBES = 16;
+	struct CallerEntry {
+		std::atomic<uintptr_t>	key;
+		std::atomic<bool>		isReady;
+		char					name[2 + sizeof(uintptr_t) * 2 + 1];
+	};
+	static CallerEntry entries[CAPACITY] = {};
+
+	const uintptr_t key = reinterpret_cast<uintptr_t>(caller);
+	if (key == 0) return "unknown";
+	size_t idx = static_cast<size_t>(key ^ (key >> 11)) % CAPACITY;
+	for (size_t probe = 0; probe < MAX_PROBES; ++probe, idx = (idx + 1) % CAPACITY) {
+		CallerEntry& entry = entries[idx];
+		uintptr_t current = entry.key.load(std::memory_order_acquire);
+		if (current == 0 && entry.key.compare_exchange_strong(current, key, std::memory_order_acq_rel, std::memory_order_acquire)) {
+			static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+			char* out = entry.name;
+			*out++ = '0';
+			*out++ = 'x';
+			for (int shift = static_cast<int>(sizeof(uintptr_t) * 8) - 4; shift >= 0; shift -= 4)
+				*out++ = HEX_DIGITS[(key >> shift) & 0xF];
+			*out = '\0';
+			entry.isReady.store(true, std::memory_order_release);
+			return entry.name;
+		}
+		if (current == key) {
+			while (!entry.isReady.load(std::memory_order_acquire)) {}	// Being named by another thread
+			return entry.name;
+		}
+	}
+	return "unknown";
 };
 #endif // !_MTP_DEBUG
 
 // Smart deallocation
 inline void MemTrackifyPlus::smartFree(void* ptr, bool isArray) {
 	if (!ptr) return;
-	MemTrackifyPlus* allocTracker = getGlobalMemTracker();
-	if (allocTracker)
+#ifdef _MTP_SMALL_OBJECT_ALLOCATOR
+	if (SmallObjectAllocator::deallocate(ptr)) return;
+#endif // _MTP_SMALL_OBJECT_ALLOCATOR
+	MemTrackifyPlus* allocTracker = GlobalMemTracker::getIfReady();
+	// Only look up the blocks that may have been tracked, the others are freed without taking the tracker lock
+	if (allocTracker && allocTracker->mayBeTracked(ptr))
 		allocTracker->reqTrackDealloc(ptr, isArray);
+	else if (allocTracker && allocTracker->isTrackingEnabled_.load(std::memory_order_relaxed))
+		freeUntracked(ptr, isArray);
+	else
+		AllocatorBackend::deallocate(ptr);  // Default: Free memory
+};
+
+// Smart batch allocation
+#ifndef _MTP_DEBUG
+inline void MemTrackifyPlus::smartAllocBatch(const size_t* sizes, void** out, size_t count, bool isArray) {
+	MemTrackifyPlus* allocTracker = getGlobalMemTracker();
+	if (allocTracker && allocTracker->isTrackingEnabled_.load(std::memory_order_relaxed))
+		allocTracker->reqTrackAllocBatch(sizes, out, count, "unknown", -1, isArray);
+	else
+		allocUntrackedBatch(sizes, out, count);
+};
+#else
+inline void MemTrackifyPlus::smartAllocBatch(const size_t* sizes, void** out, size_t count, const char* file, int line, bool isArray) {
+	MemTrackifyPlus* allocTracker = getGlobalMemTracker();
+	if (allocTracker && allocTracker->isTrackingEnabled_.load(std::memory_order_relaxed))
+		allocTracker->reqTrackAllocBatch(sizes, out, count, file, line, isArray);
 	else
-		std::free(ptr);  // Default: Free memory
+		allocUntrackedBatch(sizes, out, count);
+};
+#endif // !_MTP_DEBUG
+
+// Smart batch deallocation
+inline void MemTrackifyPlus::smartFreeBatch(void* const* ptrs, size_t count, bool isArray) {
+	MemTrackifyPlus* allocTracker = GlobalMemTracker::getIfReady();
+	if (allocTracker) {
+		allocTracker->reqTrackDeallocBatch(ptrs, count, isArray);
+		return;
+	}
+	for (size_t idx = 0; idx < count; ++idx) {
+#ifdef _MTP_SMALL_OBJECT_ALLOCATOR
+		if (SmallObjectAllocator::deallocate(ptrs[idx])) continue;
+#endif // _MTP_SMALL_OBJECT_ALLOCATOR
+		AllocatorBackend::deallocate(ptrs[idx]);  // Default: Free memory
+	}
+};
+
+// Global tracker access from signal handlers
+inline MemTrackifyPlus* MemTrackifyPlus::getGlobalMemTrackerSignalSafe(void) noexcept {
+	return GlobalMemTracker::getIfReady();
 };
 
 
@@ -542,6 +4941,33 @@ inline void* __CRTDECL operator new[](std::size_t size) {
 };
 
 #else
+
+#ifndef __CRTDECL
+	#define __CRTDECL __cdecl
+#endif
+
+// Scalar new without debug info (STL containers, libraries...), the callsite is the caller's return address
+#ifdef _MSC_VER
+	#pragma warning(disable:4595)
+	_VCRT_EXPORT_STD _NODISCARD _Ret_notnull_ _Post_writable_byte_size_(size) _VCRT_ALLOCATOR
+#else
+	_NODISCARD
+#endif // !_MSC_VER
+inline void* __CRTDECL operator new(std::size_t size) {
+	return MemTrackifyPlus::smartAlloc(size, MemTrackifyPlus::getCallerName(_MTP_RETURN_ADDRESS()), -1, false);
+};
+
+// Array new without debug info
+#ifdef _MSC_VER
+	#pragma warning(disable:4595)
+	_VCRT_EXPORT_STD _NODISCARD _Ret_notnull_ _Post_writable_byte_size_(size) _VCRT_ALLOCATOR
+#else
+	_NODISCARD
+#endif // !_MSC_VER
+inline void* __CRTDECL operator new[](std::size_t size) {
+	return MemTrackifyPlus::smartAlloc(size, MemTrackifyPlus::getCallerName(_MTP_RETURN_ADDRESS()), -1, true);
+};
+
 // Scalar new
 #ifdef _MSC_VER
 	#pragma warning(disable:4595)
@@ -638,6 +5064,691 @@ void smartDeleteArray(_Ptr_type* ptr, _Elem_count count) {
 };
 
 
+// ================================================================================
+// Typed object pool, serving objects from slabs accounted as tracker memory
+// Note: The slabs are not tracked blocks, their live objects are kept in a bitmap so that leak reports
+//		 list them one by one (the slabs are neither reported nor collected at exit).
+//		 Freed objects go to a per-thread free list, exchanged with the pool in batches.
+//		 Slabs are never released, the objects must be destroyed by the pool that made them.
+// ================================================================================
+
+template<typename _Ty, size_t _SlabObjects = 256>
+class smartPool {
+public:
+	static_assert(_SlabObjects != 0, "smartPool needs at least one object per slab");
+	static_assert(alignof(_Ty) <= alignof(std::max_align_t), "smartPool does not support over-aligned types");
+	static constexpr size_t BATCH_SIZE = (_SlabObjects < 32) ? _SlabObjects : 32;	// Objects exchanged with the pool at once
+
+	// Construct an object from the pool
+	template<typename... _Args>
+	_NODISCARD static _Ty* make(_Args&&... args) {
+		Slot* slot = popSlot();
+		_Ty* object = nullptr;
+		try {
+			object = ::new(static_cast<void*>(slot->storage)) _Ty(std::forward<_Args>(args)...);
+		}
+		catch (...) {
+			pushSlot(slot);
+			throw;
+		}
+		const size_t index = static_cast<size_t>(slot - slot->slab->slots);
+		slot->slab->liveBits[index / 64].fetch_or(static_cast<uint64_t>(1) << (index % 64), std::memory_order_relaxed);
+		return object;
+	};
+
+	// Destroy an object made by the pool (destroying an object twice is ignored)
+	static void destroy(_Ty* object) noexcept {
+		if (object == nullptr) return;
+		Slot* slot = reinterpret_cast<Slot*>(reinterpret_cast<char*>(object) - offsetof(Slot, storage));
+		const size_t index = static_cast<size_t>(slot - slot->slab->slots);
+		const uint64_t mask = static_cast<uint64_t>(1) << (index % 64);
+		if ((slot->slab->liveBits[index / 64].fetch_and(~mask, std::memory_order_relaxed) & mask) == 0) return;
+		object->~_Ty();
+		pushSlot(slot);
+	};
+
+	// Name of the pool in the reports (a string literal, e.g. the type name)
+	static void setName(const char* name) noexcept {
+		getState().registration.name = name;
+	};
+
+	// Visit each live object of the pool (other threads may keep making/destroying objects meanwhile)
+	template<typename _Visitor>
+	static void forEachLive(_Visitor&& visitor) {
+		for (Slab* slab = getState().slabs.load(std::memory_order_acquire); slab != nullptr; slab = slab->next) {
+			for (size_t word = 0; word < BITMAP_WORDS; ++word) {
+				uint64_t bits = slab->liveBits[word].load(std::memory_order_relaxed);
+				for (size_t bit = 0; bits != 0; ++bit, bits >>= 1) {
+					if (bits & 1) visitor(reinterpret_cast<_Ty*>(slab->slots[word * 64 + bit].storage));
+				}
+			}
+		}
+	};
+
+	// Attributes
+	_NODISCARD static size_t getLiveCount(void) {
+		size_t count = 0;
+		forEachLive([&count](_Ty*) { ++count; });
+		return count;
+	};
+	_NODISCARD static size_t getSlabCount(void) noexcept {
+		return getState().slabCount.load(std::memory_order_relaxed);
+	};
+
+private:
+	static constexpr size_t BITMAP_WORDS = (_SlabObjects + 63) / 64;
+
+	struct Slab;
+	struct Slot {
+		Slab*						slab;
+		Slot*						next;				// Next free slot
+		alignas(_Ty) unsigned char	storage[sizeof(_Ty)];
+	};
+	struct Slab {
+		Slab*					next;					// Next slab of the pool
+		std::atomic<uint64_t>	liveBits[BITMAP_WORDS];	// One bit per live object
+		Slot					slots[_SlabObjects];
+	};
+
+	using SlabAllocator = typename MemTrackifyPlus::InternalAllocator<Slab>;
+
+	struct FreeList {
+		Slot*	head = nullptr;
+		size_t	count = 0;
+		bool	isRegistered = false;
+		bool	isClosed = false;				// The thread is exiting, slots go straight to the pool
+	};
+	struct State {
+		// Construction (registers the pool to the leak reports)
+		State() noexcept {
+			registration.name = "smartPool";
+			registration.objectSize = sizeof(_Ty);
+			registration.forEachLive = [](void (*visitor)(const void* object, size_t size, void* context), void* context) {
+				forEachLive([visitor, context](_Ty* object) { visitor(object, sizeof(_Ty), context); });
+			};
+			MemTrackifyPlus::registerPool(registration);
+		};
+
+#ifdef _MTP_THREADSAFETY
+		MemTrackifyPlus::MutexObj			mutex;
+#endif // _MTP_THREADSAFETY
+		Slot*								freeList = nullptr;		// Free slots returned by the threads
+		std::atomic<Slab*>					slabs{ nullptr };
+		std::atomic<size_t>					slabCount{ 0 };
+		MemTrackifyPlus::PoolRegistration	registration;
+	};
+
+	// Returns the free list of a thread to the pool on thread exit
+	struct FreeListOwner {
+		FreeList* list = nullptr;
+		~FreeListOwner() {
+			if (list == nullptr) return;
+			list->isClosed = true;
+			flush(*list, list->count);
+		};
+	};
+
+	// Shared state (see MemTrackifyPlus::NeverDestroyed)
+	_NODISCARD static State& getState(void) noexcept {
+		return MemTrackifyPlus::NeverDestroyed<State>::get();
+	};
+
+	// Get the free list of the calling thread
+	_NODISCARD static FreeList& threadFreeList(void) noexcept {
+		thread_local FreeList list;
+		if (!list.isRegistered) {
+			list.isRegistered = true;
+			thread_local FreeListOwner owner;
+			owner.list = &list;
+		}
+		return list;
+	};
+
+	// Take a free slot, refill the thread free list from the pool (or from a new slab) when empty
+	_NODISCARD static Slot* popSlot(void) {
+		FreeList& list = threadFreeList();
+		if (list.head == nullptr) refill(list);
+		Slot* slot = list.head;
+		list.head = slot->next;
+		--list.count;
+		return slot;
+	};
+
+	// Give a free slot back to the thread free list
+	static void pushSlot(Slot* slot) noexcept {
+		FreeList& list = threadFreeList();
+		slot->next = list.head;
+		list.head = slot;
+		++list.count;
+		if (list.isClosed) flush(list, list.count);
+		else if (list.count > 2 * BATCH_SIZE) flush(list, BATCH_SIZE);
+	};
+
+	// Move a batch of free slots from the pool into a thread free list
+	static void refill(FreeList& list) {
+		State& state = getState();
+		{
+#ifdef _MTP_THREADSAFETY
+			MemTrackifyPlus::MutexLockGuard lock(state.mutex);
+#endif // _MTP_THREADSAFETY
+			for (size_t moved = 0; moved < BATCH_SIZE && state.freeList != nullptr; ++moved) {
+				Slot* slot = state.freeList;
+				state.freeList = slot->next;
+				slot->next = list.head;
+				list.head = slot;
+				++list.count;
+			}
+		}
+		if (list.head != nullptr) return;
+
+		// Allocate a new slab (tracker memory, see getTrackerOverhead()), all its slots go to the calling thread
+		Slab* slab = SlabAllocator().allocate(1);
+		for (auto& bits : slab->liveBits)
+			::new(&bits) std::atomic<uint64_t>(0);
+		for (size_t index = _SlabObjects; index-- != 0;) {
+			slab->slots[index].slab = slab;
+			slab->slots[index].next = list.head;
+			list.head = &slab->slots[index];
+		}
+		list.count += _SlabObjects;
+		Slab* head = state.slabs.load(std::memory_order_relaxed);
+		do {
+			slab->next = head;
+		} while (!state.slabs.compare_exchange_weak(head, slab, std::memory_order_release, std::memory_order_relaxed));
+		state.slabCount.fetch_add(1, std::memory_order_relaxed);
+	};
+
+	// Move count free slots from a thread free list back to the pool
+	static void flush(FreeList& list, size_t count) noexcept {
+		if (count == 0) return;
+		Slot* first = list.head;
+		Slot* last = first;
+		for (size_t moved = 1; moved < count; ++moved)
+			last = last->next;
+		list.head = last->next;
+		list.count -= count;
+
+		State& state = getState();
+#ifdef _MTP_THREADSAFETY
+		MemTrackifyPlus::MutexLockGuard lock(state.mutex);
+#endif // _MTP_THREADSAFETY
+		last->next = state.freeList;
+		state.freeList = first;
+	};
+};
+
+
+// ================================================================================
+// Bump-pointer arena for request-scoped allocations, its chunks are allocated through the tracker
+// Note: Each chunk is tracked as a single block (tagged with the arena name with _MTP_DEBUG).
+//		 The arena is not thread-safe and does not run the destructors of the objects it holds.
+// ================================================================================
+
+class TrackedArena {
+public:
+	static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+	struct Stats {						// Struct to hold the statistics of an arena
+		size_t		chunkCount = 0;
+		size_t		reservedBytes = 0;		// Total size of the chunks
+		size_t		usedBytes = 0;			// Bytes handed out since the last reset (alignment padding included)
+		size_t		highWaterMark = 0;		// Largest usedBytes ever reached
+		size_t		wastedTailBytes = 0;	// Unused chunk tails left behind since the last reset
+		size_t		resetCount = 0;
+	};
+
+	// Construction
+	explicit TrackedArena(const char* name, size_t chunkSize = DEFAULT_CHUNK_SIZE) noexcept
+		: name_(name), chunkSize_((chunkSize != 0) ? chunkSize : DEFAULT_CHUNK_SIZE) {};
+	~TrackedArena() { release(); };
+
+	// Allocate a block from the current chunk, or from a new one (throws std::bad_alloc on failure)
+	_NODISCARD void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+		if (size == 0) size = 1;
+		for (;;) {
+			if (current_ != nullptr) {
+				const uintptr_t position = (cursor_ + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+				if (position + size <= getChunkEnd(current_)) {
+					stats_.usedBytes += position + size - cursor_;
+					if (stats_.usedBytes > stats_.highWaterMark) stats_.highWaterMark = stats_.usedBytes;
+					cursor_ = position + size;
+					return reinterpret_cast<void*>(position);
+				}
+
+				// Move on to the next chunk kept by reset(), if it fits
+				stats_.wastedTailBytes += getChunkEnd(current_) - cursor_;
+				if (current_->next != nullptr && current_->next->size >= size + alignment) {
+					current_ = current_->next;
+					cursor_ = getChunkBegin(current_);
+					continue;
+				}
+			}
+			addChunk((size + alignment > chunkSize_) ? size + alignment : chunkSize_);
+		}
+	};
+
+	// Construct an object in the arena (its destructor is never run by the arena)
+	template<typename _Ty, typename... _Args>
+	_NODISCARD _Ty* make(_Args&&... args) {
+		return ::new(allocate(sizeof(_Ty), alignof(_Ty))) _Ty(std::forward<_Args>(args)...);
+	};
+
+	// Rewind to the first chunk, keeping all the chunks for reuse
+	void reset(void) noexcept {
+		current_ = chunks_;
+		cursor_ = (current_ != nullptr) ? getChunkBegin(current_) : 0;
+		stats_.usedBytes = 0;
+		stats_.wastedTailBytes = 0;
+		++stats_.resetCount;
+	};
+
+	// Free all the chunks
+	void release(void) noexcept {
+		while (chunks_ != nullptr) {
+			Chunk* next = chunks_->next;
+			MemTrackifyPlus::smartFree(chunks_, false);
+			chunks_ = next;
+		}
+		current_ = nullptr;
+		cursor_ = 0;
+		stats_.chunkCount = stats_.reservedBytes = stats_.usedBytes = stats_.wastedTailBytes = 0;
+	};
+
+	// Attributes
+	_NODISCARD const char* getName(void) const noexcept { return name_; };
+	_NODISCARD const Stats& getStats(void) const noexcept { return stats_; };
+
+private:
+	// No copyable
+	TrackedArena(const TrackedArena&) = delete;
+	TrackedArena& operator=(const TrackedArena&) = delete;
+
+	struct alignas(std::max_align_t) Chunk {
+		Chunk*		next;
+		size_t		size;					// Usable size, after the header
+	};
+
+	// Allocate a chunk through the tracker and insert it after the current one
+	void addChunk(size_t size) {
+#ifndef _MTP_DEBUG
+		Chunk* chunk = static_cast<Chunk*>(MemTrackifyPlus::smartAlloc(sizeof(Chunk) + size, false));
+#else
+		Chunk* chunk = static_cast<Chunk*>(MemTrackifyPlus::smartAlloc(sizeof(Chunk) + size, name_, -1, false));
+#endif // !_MTP_DEBUG
+		if (chunk == nullptr) throw std::bad_alloc();
+		chunk->size = size;
+		if (current_ != nullptr) {
+			chunk->next = current_->next;
+			current_->next = chunk;
+		}
+		else {
+			chunk->next = chunks_;
+			chunks_ = chunk;
+		}
+		current_ = chunk;
+		cursor_ = getChunkBegin(chunk);
+		++stats_.chunkCount;
+		stats_.reservedBytes += size;
+	};
+
+	_NODISCARD static uintptr_t getChunkBegin(const Chunk* chunk) noexcept {
+		return reinterpret_cast<uintptr_t>(chunk + 1);
+	};
+	_NODISCARD static uintptr_t getChunkEnd(const Chunk* chunk) noexcept {
+		return getChunkBegin(chunk) + chunk->size;
+	};
+
+private:
+	const char*		name_;
+	size_t			chunkSize_;
+	Chunk*			chunks_ = nullptr;			// All the chunks, in use order
+	Chunk*			current_ = nullptr;
+	uintptr_t		cursor_ = 0;				// Next free byte of the current chunk
+	Stats			stats_;
+};
+
+
+// ================================================================================
+// Polymorphic memory resources recording their blocks into a tracker (C++ 17 or later)
+// Note: These work without the overridden global new/delete operators (_MTP_NO_OVERRIDE_GLOBAL_OPERATORS).
+// ================================================================================
+
+#if _HAS_CXX17 && __has_include(<memory_resource>)
+namespace mtp {
+
+// Memory resource forwarding to an upstream resource, its blocks are recorded into a tracker with a tag
+// (reported as their file with _MTP_DEBUG). Its thread-safety is the one of the upstream resource.
+class tracking_resource : public std::pmr::memory_resource {
+public:
+	// Construction
+	explicit tracking_resource(const char* tag = "pmr", std::pmr::memory_resource* upstream = std::pmr::get_default_resource(),
+							   MemTrackifyPlus* tracker = getGlobalMemTracker()) noexcept
+		: tag_(tag), upstream_(upstream), tracker_(tracker) {};
+	tracking_resource(const tracking_resource&) = delete;
+	tracking_resource& operator=(const tracking_resource&) = delete;
+
+	// Attributes
+	_NODISCARD const char* tag(void) const noexcept { return tag_; };
+	_NODISCARD std::pmr::memory_resource* upstream_resource(void) const noexcept { return upstream_; };
+	_NODISCARD MemTrackifyPlus* tracker(void) const noexcept { return tracker_; };
+	_NODISCARD size_t live_count(void) const noexcept { return liveCount_.load(std::memory_order_relaxed); };
+	_NODISCARD size_t live_bytes(void) const noexcept { return liveBytes_.load(std::memory_order_relaxed); };
+	_NODISCARD size_t size_mismatch_count(void) const noexcept { return sizeMismatchCount_.load(std::memory_order_relaxed); };
+
+protected:
+	void* do_allocate(size_t bytes, size_t alignment) override {
+		void* ptr = upstream_->allocate(bytes, alignment);
+		if (tracker_ != nullptr) tracker_->trackExternalAlloc(ptr, bytes, tag_);
+		liveCount_.fetch_add(1, std::memory_order_relaxed);
+		liveBytes_.fetch_add(bytes, std::memory_order_relaxed);
+		return ptr;
+	};
+	void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+		// The size given back must be the one of the allocation
+		if (tracker_ != nullptr) {
+			const size_t trackedSize = tracker_->trackExternalFree(ptr);
+			if (trackedSize != 0 && trackedSize != bytes) sizeMismatchCount_.fetch_add(1, std::memory_order_relaxed);
+		}
+		liveCount_.fetch_sub(1, std::memory_order_relaxed);
+		liveBytes_.fetch_sub(bytes, std::memory_order_relaxed);
+		upstream_->deallocate(ptr, bytes, alignment);
+	};
+	_NODISCARD bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+		return this == &other;
+	};
+
+private:
+	const char*					tag_;
+	std::pmr::memory_resource*	upstream_;
+	MemTrackifyPlus*			tracker_;
+	std::atomic<size_t>			liveCount_{ 0 };
+	std::atomic<size_t>			liveBytes_{ 0 };
+	std::atomic<size_t>			sizeMismatchCount_{ 0 };
+};
+
+// Holds the tracking upstream of the tracked resources below, so that it is constructed before them
+class tracking_upstream_holder {
+public:
+	// Construction
+	tracking_upstream_holder(const char* tag, std::pmr::memory_resource* upstream, MemTrackifyPlus* tracker) noexcept
+		: tracking_(tag, upstream, tracker) {};
+
+	// Attributes
+	_NODISCARD const tracking_resource& tracking(void) const noexcept { return tracking_; };
+
+protected:
+	tracking_resource tracking_;
+};
+
+// Monotonic buffer resource whose buffers are recorded into a tracker
+class tracked_monotonic_buffer_resource : public tracking_upstream_holder, public std::pmr::monotonic_buffer_resource {
+public:
+	// Construction
+	explicit tracked_monotonic_buffer_resource(const char* tag, std::pmr::memory_resource* upstream = std::pmr::get_default_resource(),
+											   MemTrackifyPlus* tracker = getGlobalMemTracker())
+		: tracking_upstream_holder(tag, upstream, tracker), std::pmr::monotonic_buffer_resource(&tracking_) {};
+	tracked_monotonic_buffer_resource(const char* tag, size_t initialSize, std::pmr::memory_resource* upstream = std::pmr::get_default_resource(),
+									  MemTrackifyPlus* tracker = getGlobalMemTracker())
+		: tracking_upstream_holder(tag, upstream, tracker), std::pmr::monotonic_buffer_resource(initialSize, &tracking_) {};
+};
+
+// Unsynchronized pool resource whose chunks are recorded into a tracker
+class tracked_unsynchronized_pool_resource : public tracking_upstream_holder, public std::pmr::unsynchronized_pool_resource {
+public:
+	// Construction
+	explicit tracked_unsynchronized_pool_resource(const char* tag, const std::pmr::pool_options& options = {},
+												  std::pmr::memory_resource* upstream = std::pmr::get_default_resource(),
+												  MemTrackifyPlus* tracker = getGlobalMemTracker())
+		: tracking_upstream_holder(tag, upstream, tracker), std::pmr::unsynchronized_pool_resource(options, &tracking_) {};
+};
+
+} // namespace mtp
+#endif // _HAS_CXX17 && __has_include(<memory_resource>)
+
+
+// ================================================================================
+// STL allocator routed through the tracker, with counters per tag type
+// Note: Growth is detected per container instance: a free that directly follows a larger allocation
+//		 of the same tag on the same thread is a reallocation (e.g. a vector growing), the instance is then
+//		 followed through its new buffer until its last buffer is freed. The instances are followed by the
+//		 thread growing them (no lock), an instance freed by another thread is counted with the reallocations
+//		 known to that thread.
+// ================================================================================
+
+namespace mtp {
+
+// Default tag of TrackingAllocator (a tag is any type, with an optional static constexpr const char* name)
+struct DefaultAllocatorTag {
+	static constexpr const char* name = "default";
+};
+
+// Counters of a tag, shared by all the TrackingAllocator types of the tag
+class AllocatorTagState {
+public:
+	static constexpr size_t HISTOGRAM_SIZE = 33;		// Number of reallocations of the container instances, the last bucket collects 32 or more
+	static constexpr size_t MAX_THREAD_CHAINS = 4096;	// Instances followed per thread, the oldest are forgotten beyond
+
+	struct Stats {						// Struct to hold a copy of the counters of a tag
+		const char*	name = nullptr;
+		size_t		allocCount = 0;
+		size_t		freeCount = 0;
+		size_t		liveBytes = 0;
+		size_t		peakBytes = 0;
+		size_t		reallocCount = 0;					// Reallocation events (growth)
+		size_t		bytesCopied = 0;					// Bytes moved from the old buffers during growth
+		size_t		instanceCount = 0;					// Container instances whose last buffer was freed
+		size_t		reallocHistogram[HISTOGRAM_SIZE] = {};	// Instances per number of reallocations
+		size_t		largestFinalBytes[HISTOGRAM_SIZE] = {};	// Largest last buffer of the instances of each bucket
+	};
+
+	// Construction
+	explicit AllocatorTagState(const char* name) noexcept : name_(name) {
+		AllocatorTagState* head = registry().load(std::memory_order_relaxed);
+		do {
+			next_ = head;
+		} while (!registry().compare_exchange_weak(head, this, std::memory_order_release, std::memory_order_relaxed));
+	};
+
+	// Record a new buffer
+	void onAllocate(void* ptr, size_t bytes) noexcept {
+		allocCount_.fetch_add(1, std::memory_order_relaxed);
+		const size_t liveBytes = liveBytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+		atomicMax(peakBytes_, liveBytes);
+		ThreadChains* chains = threadChains();
+		if (chains != nullptr) chains->last = { this, ptr, bytes };
+	};
+
+	// Record a freed buffer, which is a reallocation if it directly follows a larger allocation on this thread
+	void onDeallocate(void* ptr, size_t bytes) {
+		freeCount_.fetch_add(1, std::memory_order_relaxed);
+		liveBytes_.fetch_sub(bytes, std::memory_order_relaxed);
+		ThreadChains* chains = threadChains();
+		if (chains == nullptr) return;	// Thread exiting, its chains are gone
+		const LastAllocation last = chains->last;
+		chains->last.state = nullptr;
+		const bool isGrowth = (last.state == this) && (last.ptr != ptr) && (last.bytes > bytes);
+
+		size_t reallocCount = 0;
+		if (!chains->reallocs.empty()) {
+			auto it = chains->reallocs.find(ptr);
+			if (it != chains->reallocs.end()) {
+				reallocCount = it->second;
+				chains->reallocs.erase(it);
+			}
+		}
+		if (isGrowth) {
+			// The instance lives on in its new buffer
+			if (chains->reallocs.size() >= MAX_THREAD_CHAINS) chains->reallocs.clear();
+			chains->reallocs[last.ptr] = reallocCount + 1;
+			reallocCount_.fetch_add(1, std::memory_order_relaxed);
+			bytesCopied_.fetch_add(bytes, std::memory_order_relaxed);
+			return;
+		}
+		const size_t bucket = (reallocCount < HISTOGRAM_SIZE - 1) ? reallocCount : HISTOGRAM_SIZE - 1;
+		instanceCount_.fetch_add(1, std::memory_order_relaxed);
+		reallocHistogram_[bucket].fetch_add(1, std::memory_order_relaxed);
+		atomicMax(largestFinalBytes_[bucket], bytes);
+	};
+
+	// Get a copy of the counters
+	_NODISCARD Stats getStats(void) const noexcept {
+		Stats stats;
+		stats.name = name_;
+		stats.allocCount = allocCount_.load(std::memory_order_relaxed);
+		stats.freeCount = freeCount_.load(std::memory_order_relaxed);
+		stats.liveBytes = liveBytes_.load(std::memory_order_relaxed);
+		stats.peakBytes = peakBytes_.load(std::memory_order_relaxed);
+		stats.reallocCount = reallocCount_.load(std::memory_order_relaxed);
+		stats.bytesCopied = bytesCopied_.load(std::memory_order_relaxed);
+		stats.instanceCount = instanceCount_.load(std::memory_order_relaxed);
+		for (size_t bucket = 0; bucket < HISTOGRAM_SIZE; ++bucket) {
+			stats.reallocHistogram[bucket] = reallocHistogram_[bucket].load(std::memory_order_relaxed);
+			stats.largestFinalBytes[bucket] = largestFinalBytes_[bucket].load(std::memory_order_relaxed);
+		}
+		return stats;
+	};
+
+	// Print the counters of every tag, with the container instances that reallocated more than minReallocs times
+	// and the largest buffer they ended with (a capacity to reserve up front)
+	static void printReport(std::ostream& os, size_t minReallocs = 10) {
+		os << "\n--- Tracking Allocator Tags ---\n";
+		for (const AllocatorTagState* state = registry().load(std::memory_order_acquire); state != nullptr; state = state->next_) {
+			const Stats stats = state->getStats();
+			os << stats.name << ": " << stats.allocCount << " allocations, " << stats.liveBytes << " live bytes (peak: " << stats.peakBytes
+				<< "), " << stats.reallocCount << " reallocations copying " << stats.bytesCopied << " bytes.\n";
+			size_t instances = 0;
+			size_t largestBytes = 0;
+			for (size_t bucket = minReallocs + 1; bucket < HISTOGRAM_SIZE; ++bucket) {
+				instances += stats.reallocHistogram[bucket];
+				if (stats.largestFinalBytes[bucket] > largestBytes) largestBytes = stats.largestFinalBytes[bucket];
+			}
+			if (instances != 0) {
+				os << "  " << instances << " of " << stats.instanceCount << " containers reallocated more than " << minReallocs
+					<< " times, reserve up to " << largestBytes << " bytes up front.\n";
+			}
+		}
+	};
+
+private:
+	// No copyable
+	AllocatorTagState(const AllocatorTagState&) = delete;
+	AllocatorTagState& operator=(const AllocatorTagState&) = delete;
+
+	struct LastAllocation {				// Last buffer allocated by the calling thread
+		const AllocatorTagState*	state;
+		void*						ptr;
+		size_t						bytes;
+	};
+	using ReallocData = std::unordered_map<void*, size_t, std::hash<void*>, std::equal_to<void*>,
+										   MemTrackifyPlus::InternalAllocator<std::pair<void* const, size_t>>>;
+	struct ThreadChains {				// Container instances followed by the calling thread (all tags)
+		LastAllocation	last = { nullptr, nullptr, 0 };
+		ReallocData		reallocs;		// Reallocations so far of the instances, by current buffer
+		~ThreadChains() { isDestroyed() = true; };
+	};
+	// Note: Containers freed after the thread locals of their thread (e.g. statics freed by the main thread
+	//		 at exit) are counted without chains
+	_NODISCARD static bool& isDestroyed(void) noexcept {
+		thread_local bool destroyed = false;	// Trivially destructible, readable after ThreadChains is gone
+		return destroyed;
+	};
+	_NODISCARD static ThreadChains* threadChains(void) noexcept {
+		if (isDestroyed()) return nullptr;
+		thread_local ThreadChains chains;
+		return &chains;
+	};
+
+	_NODISCARD static std::atomic<AllocatorTagState*>& registry(void) noexcept {
+		static std::atomic<AllocatorTagState*> stateList(nullptr);
+		return stateList;
+	};
+
+	static void atomicMax(std::atomic<size_t>& target, size_t value) noexcept {
+		size_t current = target.load(std::memory_order_relaxed);
+		while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+	};
+
+private:
+	const char*				name_;
+	AllocatorTagState*		next_ = nullptr;
+	std::atomic<size_t>		allocCount_{ 0 };
+	std::atomic<size_t>		freeCount_{ 0 };
+	std::atomic<size_t>		liveBytes_{ 0 };
+	std::atomic<size_t>		peakBytes_{ 0 };
+	std::atomic<size_t>		reallocCount_{ 0 };
+	std::atomic<size_t>		bytesCopied_{ 0 };
+	std::atomic<size_t>		instanceCount_{ 0 };
+	std::atomic<size_t>		reallocHistogram_[HISTOGRAM_SIZE] = {};
+	std::atomic<size_t>		largestFinalBytes_[HISTOGRAM_SIZE] = {};
+};
+
+// Name of a tag ("default" without a name member)
+template<typename _Tag>
+_NODISCARD auto selectAllocatorTagName(int) noexcept -> decltype(static_cast<const char*>(_Tag::name)) { return _Tag::name; };
+template<typename _Tag>
+_NODISCARD const char* selectAllocatorTagName(...) noexcept { return "default"; };
+template<typename _Tag>
+_NODISCARD const char* getAllocatorTagName(void) noexcept { return selectAllocatorTagName<_Tag>(0); };
+
+// Counters of a tag (see MemTrackifyPlus::NeverDestroyed)
+template<typename _Tag>
+_NODISCARD AllocatorTagState& getAllocatorTagState(void) noexcept {
+	return MemTrackifyPlus::NeverDestroyed<AllocatorTagState, _Tag>::get(getAllocatorTagName<_Tag>());
+};
+
+// Stateless STL allocator, its blocks are allocated through MemTrackifyPlus::smartAlloc()
+// (tagged with the tag name with _MTP_DEBUG) and counted per tag, e.g.
+//   struct OrderTag { static constexpr const char* name = "orders"; };
+//   std::vector<Order, mtp::TrackingAllocator<Order, OrderTag>> orders;
+template<typename _Ty, typename _Tag = DefaultAllocatorTag>
+class TrackingAllocator {
+public:
+	static_assert(alignof(_Ty) <= alignof(std::max_align_t), "TrackingAllocator does not support over-aligned types");
+
+	using value_type = _Ty;
+	template<typename _Other>
+	struct rebind { using other = TrackingAllocator<_Other, _Tag>; };
+
+	// Construction
+	TrackingAllocator() noexcept = default;
+	template<typename _Other>
+	TrackingAllocator(const TrackingAllocator<_Other, _Tag>&) noexcept {};
+
+	// Operations
+	_NODISCARD _Ty* allocate(size_t count) {
+		const size_t bytes = count * sizeof(_Ty);
+#ifndef _MTP_DEBUG
+		void* ptr = MemTrackifyPlus::smartAlloc(bytes, false);
+#else
+		void* ptr = MemTrackifyPlus::smartAlloc(bytes, getAllocatorTagName<_Tag>(), -1, false);
+#endif // !_MTP_DEBUG
+		if (ptr == nullptr) throw std::bad_alloc();
+		getTagState().onAllocate(ptr, bytes);
+		return static_cast<_Ty*>(ptr);
+	};
+	void deallocate(_Ty* ptr, size_t count) noexcept {
+		if (ptr == nullptr) return;
+		try {
+			getTagState().onDeallocate(ptr, count * sizeof(_Ty));
+		}
+		catch (...) {}					// Losing a growth chain must not lose the block
+		MemTrackifyPlus::smartFree(ptr, false);
+	};
+
+	// Counters of the tag
+	_NODISCARD static AllocatorTagState& getTagState(void) noexcept {
+		return getAllocatorTagState<_Tag>();
+	};
+
+	template<typename _Other>
+	_NODISCARD bool operator==(const TrackingAllocator<_Other, _Tag>&) const noexcept { return true; };
+	template<typename _Other>
+	_NODISCARD bool operator!=(const TrackingAllocator<_Other, _Tag>&) const noexcept { return false; };
+};
+
+} // namespace mtp
+
+
 // ================================================================================
 // Override global new/delete operators for debugging
 // ================================================================================